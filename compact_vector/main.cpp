@@ -27,7 +27,12 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <algorithm>
+#include <chrono>
 #include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include <sax/iostream.hpp>
 
 #include <sax/splitmix.hpp>
@@ -35,6 +40,9 @@
 
 #define USE_MIMALLC false
 
+#include "compact_cow_vector.hpp"
+#include "compact_delta_vector.hpp"
+#include "compact_soa_vector.hpp"
 #include "compact_vector.hpp"
 
 // -fsanitize=address
@@ -76,6 +84,256 @@ void test_eb ( ) {
             emplace_back_random<Con> ( i );
 }
 
+// Checks compact_delta_vector against a std::vector, a block of 128 equal values (packed at 0 bits),
+// blocks of random gaps and a tail of unpacked values, lower_bound ( ) landing in each.
+void test_delta ( ) {
+    using Con = sax::compact_delta_vector<std::uint32_t>;
+    sax::splitmix64 gen;
+    Con cdv;
+    std::vector<std::uint32_t> ref;
+    auto push_back = [ & ] ( std::uint32_t v_ ) {
+        cdv.push_back ( v_ );
+        ref.push_back ( v_ );
+        assert ( cdv.size ( ) == static_cast<Con::size_type> ( ref.size ( ) ) and cdv.back ( ) == v_ );
+    };
+    auto push_back_random = [ & ] ( int n_ ) {
+        for ( int i = 0; i < n_; ++i )
+            push_back ( ( ref.size ( ) ? ref.back ( ) : 1'000u ) +
+                        sax::uniform_int_distribution<std::uint32_t> ( 0u, 1u << ( i % 20 ) ) ( gen ) );
+    };
+    push_back_random ( Con::block_size );
+    for ( int i = 0; i < Con::block_size; ++i ) // All deltas 0.
+        push_back ( ref.back ( ) );
+    push_back_random ( Con::block_size + 37 );
+    std::vector<std::uint32_t> decoded ( ref.size ( ) );
+    cdv.decode ( decoded.data ( ) );
+    assert ( decoded == ref );
+    [[maybe_unused]] std::size_t i = 0;
+    for ( [[maybe_unused]] std::uint32_t const v : cdv )
+        assert ( v == ref[ i++ ] );
+    assert ( i == ref.size ( ) );
+    auto check = [ & ] ( std::uint32_t v_ ) {
+        auto const r  = std::lower_bound ( ref.begin ( ), ref.end ( ), v_ );
+        [[maybe_unused]] auto const it = cdv.lower_bound ( v_ );
+        if ( r == ref.end ( ) ) {
+            assert ( it == cdv.end ( ) );
+        }
+        else {
+            assert ( it != cdv.end ( ) and *it == *r and it.index ( ) == r - ref.begin ( ) );
+        }
+        assert ( cdv.contains ( v_ ) == std::binary_search ( ref.begin ( ), ref.end ( ), v_ ) );
+    };
+    check ( 0u );
+    check ( ref[ Con::block_size ] );
+    check ( ref.back ( ) );
+    check ( ref.back ( ) + 1u );
+    for ( std::uint32_t const v : ref ) {
+        check ( v - 1u );
+        check ( v );
+        check ( v + 1u );
+    }
+    // Intersect, seeking forward with skip_to ( ).
+    std::vector<std::uint32_t> probes, expected, intersection;
+    for ( std::size_t j = 0; j < ref.size ( ); j += 3 )
+        probes.push_back ( ref[ j ] + static_cast<std::uint32_t> ( j % 2 ) );
+    std::sort ( probes.begin ( ), probes.end ( ) );
+    probes.erase ( std::unique ( probes.begin ( ), probes.end ( ) ), probes.end ( ) );
+    std::set_intersection ( probes.begin ( ), probes.end ( ), ref.begin ( ), ref.end ( ), std::back_inserter ( expected ) );
+    Con::const_iterator it = cdv.begin ( );
+    for ( std::uint32_t const v : probes )
+        if ( it.skip_to ( v ) != cdv.end ( ) and *it == v )
+            intersection.push_back ( v );
+    assert ( intersection == expected );
+    // Small gaps from a large first value, below the raw size, also short of a full block.
+    for ( std::uint32_t const n : { 50u, 256u } ) {
+        Con gaps;
+        for ( std::uint32_t j = 0; j < n; ++j )
+            gaps.push_back ( 50'000'000u + 3u * j );
+        gaps.shrink_to_fit ( );
+        assert ( gaps.bytes ( ) < n * sizeof ( std::uint32_t ) );
+    }
+}
+
+// Checks that compact_cow_vector copies share the block and that mutating detaches, also after handing
+// out a mutable reference, which makes the next copy a deep copy.
+void test_cow ( ) {
+    using Con = sax::compact_cow_vector<int>;
+    Con a;
+    for ( int i = 0; i < 3; ++i )
+        a.push_back ( i );
+    Con b = a;
+    assert ( a.use_count ( ) == 2 and std::as_const ( a ).data ( ) == std::as_const ( b ).data ( ) );
+    b.push_back ( 3 ); // push_back ( ).
+    assert ( a.use_count ( ) == 1 and b.use_count ( ) == 1 and a.size ( ) == 3 and b.size ( ) == 4 );
+    Con c = a;
+    c.resize ( 5 ); // resize ( ).
+    assert ( a.use_count ( ) == 1 and c.use_count ( ) == 1 and a.size ( ) == 3 and c.size ( ) == 5 and c[ 4 ] == 0 );
+    Con d = a;
+    d.clear ( ); // clear ( ).
+    assert ( a.use_count ( ) == 1 and d.empty ( ) and a.size ( ) == 3 );
+    Con e = a;
+    e[ 0 ] = 7; // operator[] ( ).
+    assert ( a.use_count ( ) == 1 and e.use_count ( ) == 1 and std::as_const ( a )[ 0 ] == 0 and std::as_const ( e )[ 0 ] == 7 );
+    // A copy after handing out a reference does not share.
+    int & r = a[ 1 ];
+    Con f   = a;
+    r       = 9;
+    assert ( not a.is_shareable ( ) and f.use_count ( ) == 1 and std::as_const ( f )[ 1 ] == 1 );
+    f.push_back ( 3 );
+    Con g = f;
+    assert ( f.use_count ( ) == 2 ); // Copies of the copy share.
+    a.clear ( );
+    assert ( a.is_shareable ( ) );
+    // Self-assignment.
+    Con & h = g;
+    g       = h;
+    assert ( g.use_count ( ) == 2 and g == f );
+    f = g;
+    assert ( f.use_count ( ) == 2 );
+}
+
+// A non-trivially copyable value, which counts its live instances and throws when constructed from
+// throw_on.
+struct soa_counted {
+    static inline int live = 0, throw_on = -1;
+    int value;
+    soa_counted ( int v_ = 0 ) : value{ v_ } {
+        if ( v_ == throw_on )
+            throw std::runtime_error ( "soa_counted" );
+        ++live;
+    }
+    soa_counted ( soa_counted const & o_ ) : soa_counted{ o_.value } {}
+    soa_counted ( soa_counted && o_ ) noexcept : value{ o_.value } { ++live; }
+    ~soa_counted ( ) noexcept { --live; }
+};
+
+// Checks compact_soa_vector with non-trivially copyable columns, on relocating (reserve, emplace_back),
+// resize, copy, and that a throwing constructor leaves no values behind.
+void test_soa ( ) {
+    using Con = sax::compact_soa_vector<float, std::string, soa_counted>;
+    auto text = [] ( int i_ ) { return std::string ( 32, 'a' ) + std::to_string ( i_ ); }; // Not short.
+    {
+        Con v;
+        for ( int i = 0; i < 100; ++i )
+            v.emplace_back ( static_cast<float> ( i ), text ( i ), i );
+        v.reserve ( 1'000 );
+        assert ( v.size ( ) == 100 and v.capacity ( ) == 1'000 and soa_counted::live == 100 );
+        for ( int i = 0; i < 100; ++i )
+            assert ( std::get<0> ( v[ i ] ) == static_cast<float> ( i ) and std::get<1> ( v[ i ] ) == text ( i ) and
+                     std::get<2> ( v[ i ] ).value == i );
+        Con w = v;
+        assert ( w.size ( ) == 100 and soa_counted::live == 200 and std::get<1> ( w[ 99 ] ) == text ( 99 ) );
+        w.resize ( 50 );
+        w.resize ( 60 );
+        assert ( soa_counted::live == 160 and std::get<1> ( w[ 55 ] ).empty ( ) and std::get<2> ( w[ 49 ] ).value == 49 );
+        soa_counted::throw_on = 1'000;
+        try {
+            v.emplace_back ( 1.0f, text ( 100 ), 1'000 );
+            assert ( false );
+        }
+        catch ( std::runtime_error const & ) {
+        }
+        assert ( v.size ( ) == 100 and soa_counted::live == 160 );
+        soa_counted::throw_on = 42;
+        try {
+            Con x = v;
+            assert ( false );
+        }
+        catch ( std::runtime_error const & ) {
+        }
+        assert ( soa_counted::live == 160 );
+        soa_counted::throw_on = -1;
+    }
+    assert ( soa_counted::live == 0 );
+}
+
+// Appending with emplace_back ( ), through a bulk_writer and writing into a raw array. The bulk_writer
+// loop should compile to the same (vectorized) code as the raw array loop.
+void bench_bulk_writer ( ) {
+
+    using cvec = sax::compact_vector<int, std::int32_t>;
+
+    const int sz = 1'024;
+    const int nn = 100'000; // Number of iteration in tester loops
+    std::chrono::time_point<std::chrono::system_clock> start1, end1, start2, end2, start3, end3;
+    std::int64_t sink = 0;
+
+    start1 = std::chrono::system_clock::now ( );
+    for ( int i = 0; i < nn; ++i ) {
+        cvec v;
+        v.reserve ( sz );
+        for ( int j = 0; j < sz; ++j )
+            v.emplace_back ( j );
+        sink += v.back ( );
+    }
+    end1           = std::chrono::system_clock::now ( );
+    float elapsed1 = std::chrono::duration_cast<std::chrono::microseconds> ( end1 - start1 ).count ( );
+
+    start2 = std::chrono::system_clock::now ( );
+    for ( int i = 0; i < nn; ++i ) {
+        cvec v;
+        {
+            auto w = v.writer ( sz );
+            for ( int j = 0; j < sz; ++j )
+                w.emplace_back ( j );
+        }
+        sink += v.back ( );
+    }
+    end2           = std::chrono::system_clock::now ( );
+    float elapsed2 = std::chrono::duration_cast<std::chrono::microseconds> ( end2 - start2 ).count ( );
+
+    start3 = std::chrono::system_clock::now ( );
+    for ( int i = 0; i < nn; ++i ) {
+        int * a = static_cast<int *> ( std::malloc ( sz * sizeof ( int ) ) );
+        for ( int j = 0; j < sz; ++j )
+            a[ j ] = j;
+        sink += a[ sz - 1 ];
+        std::free ( a );
+    }
+    end3           = std::chrono::system_clock::now ( );
+    float elapsed3 = std::chrono::duration_cast<std::chrono::microseconds> ( end3 - start3 ).count ( );
+
+    std::cout << "emplace_back - " << elapsed1 << ", bulk_writer - " << elapsed2 << ", raw - " << elapsed3
+              << "\nbulk_writer gain: " << elapsed1 / elapsed2 << "\nraw gain: " << elapsed1 / elapsed3 << "\n(" << sink << ")"
+              << nl;
+}
+
+// Sorting with sort ( ), i.e. a radix sort for integers, versus std::sort.
+template<typename Type>
+void bench_sort ( ) {
+
+    using cvec = sax::compact_vector<Type, std::int32_t>;
+
+    const int sz = 1'000'000;
+    const int nn = 10; // Number of iteration in tester loops
+    sax::splitmix64 gen;
+    cvec data;
+    {
+        auto w = data.writer ( sz );
+        for ( int j = 0; j < sz; ++j )
+            w.emplace_back ( static_cast<Type> ( gen ( ) ) );
+    }
+    std::chrono::microseconds elapsed1{ 0 }, elapsed2{ 0 };
+
+    for ( int i = 0; i < nn; ++i ) {
+        cvec v           = data;
+        auto const start = std::chrono::system_clock::now ( );
+        std::sort ( v.begin ( ), v.end ( ) );
+        elapsed1 += std::chrono::duration_cast<std::chrono::microseconds> ( std::chrono::system_clock::now ( ) - start );
+    }
+
+    for ( int i = 0; i < nn; ++i ) {
+        cvec v           = data;
+        auto const start = std::chrono::system_clock::now ( );
+        v.sort ( );
+        elapsed2 += std::chrono::duration_cast<std::chrono::microseconds> ( std::chrono::system_clock::now ( ) - start );
+        assert ( std::is_sorted ( v.begin ( ), v.end ( ) ) );
+    }
+
+    std::cout << sizeof ( Type ) << " bytes, std::sort - " << elapsed1.count ( ) << ", sort - " << elapsed2.count ( )
+              << "\nsort gain: " << static_cast<float> ( elapsed1.count ( ) ) / elapsed2.count ( ) << nl;
+}
+
 int main ( ) {
 
     std::exception_ptr eptr;
@@ -114,6 +372,12 @@ int main ( ) {
         std::cout << w << nl;
 
         // test_eb ( );
+        test_delta ( );
+        test_cow ( );
+        test_soa ( );
+        // bench_bulk_writer ( );
+        // bench_sort<std::uint32_t> ( );
+        // bench_sort<std::uint64_t> ( );
     }
     catch ( ... ) {
         eptr = std::current_exception ( ); // Capture.
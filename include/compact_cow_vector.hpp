@@ -0,0 +1,419 @@
+// MIT License
+//
+// Copyright (c) 2020 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "compact_vector.hpp"
+
+namespace sax {
+
+namespace detail::cv {
+
+// The block header of a shared vector, a reference count next to capacity and size. The header is
+// aligned, such that the values following it are as well.
+template<typename Type, typename SizeType = int>
+struct alignas ( std::max ( alignof ( Type ), alignof ( std::atomic<SizeType> ) ) ) shared_params {
+
+    using value_type    = Type;
+    using pointer       = value_type *;
+    using const_pointer = value_type const *;
+
+    using size_type = SizeType;
+
+    std::atomic<size_type> count;
+    size_type capacity, size;
+    bool unshareable; // A mutable reference into the block has been handed out.
+};
+
+} // namespace detail::cv
+
+// A copy-on-write compact_vector. Copies share the block and bump the reference count in its header,
+// any mutating member first detaches, i.e. gives the handle its own copy of the block if it is shared.
+// The non-const accessors and iterators hand out mutable references, which would write through to
+// later copies, so they also mark the block unshareable (as the COW std::string did), the next copy
+// is then a deep copy. The mark is cleared when the references are invalidated, i.e. on reallocation
+// or clear ( ). Use the const interface (or std::as_const) to read without detaching or marking. For
+// the same reason emplace_back ( ) and push_back ( ) return nothing, unlike compact_vector.
+template<typename Type, typename SizeType = int, SizeType max_allocation_size = std::numeric_limits<SizeType>::max ( ),
+         SizeType default_allocation_size = 1>
+class compact_cow_vector {
+
+    public:
+    using value_type    = Type;
+    using pointer       = value_type *;
+    using const_pointer = value_type const *;
+
+    using reference       = value_type &;
+    using const_reference = value_type const &;
+    using rv_reference    = value_type &&;
+
+    using size_type       = SizeType;
+    using difference_type = std::make_signed_t<size_type>;
+
+    using iterator       = pointer;
+    using const_iterator = const_pointer;
+
+    using void_ptr = void *;
+    using params   = detail::cv ::shared_params<value_type, size_type>;
+
+    static_assert ( default_allocation_size > 0, "Default allocation size must be positive" );
+
+    // Construct.
+
+    explicit compact_cow_vector ( ) noexcept {}
+    compact_cow_vector ( size_type const size_ ) {
+        cv_malloc ( size_, size_ );
+        std::for_each ( m_data, m_data + size_,
+                        [] ( value_type & value_ref ) { new ( &value_ref ) value_type{ }; } ); // default construct values.
+    }
+    compact_cow_vector ( compact_cow_vector const & cv_ ) {
+        if ( cv_.is_shareable ( ) ) {
+            m_data = acquire ( cv_.m_data );
+            return;
+        }
+        try {
+            copy_from ( cv_.m_data, cv_.size_ref ( ) );
+        }
+        catch ( ... ) {
+            reset ( );
+            throw;
+        }
+    }
+    compact_cow_vector ( compact_cow_vector && cv_ ) noexcept : m_data{ std::exchange ( cv_.m_data, nullptr ) } {}
+
+    ~compact_cow_vector ( ) noexcept { release ( m_data ); }
+
+    // Assignment.
+
+    [[maybe_unused]] compact_cow_vector & operator= ( compact_cow_vector const & rhs_ ) {
+        if ( m_data != rhs_.m_data ) // Self-assignment, or sharing the block already.
+            compact_cow_vector{ rhs_ }.swap ( *this );
+        return *this;
+    }
+
+    [[maybe_unused]] compact_cow_vector & operator= ( compact_cow_vector && rhs_ ) noexcept {
+        if ( this != &rhs_ ) {
+            release ( m_data );
+            m_data = std::exchange ( rhs_.m_data, nullptr );
+        }
+        return *this;
+    }
+
+    // Manage.
+
+    void clear ( ) noexcept {
+        if ( m_data ) {
+            if ( is_unique ( ) ) {
+                std::for_each ( m_data, m_data + size_ref ( ), [] ( value_type & value_ref ) { value_ref.~Type ( ); } );
+                size_ref ( )                = 0;
+                params_ref ( ).unshareable = false;
+            }
+            else {
+                reset ( );
+            }
+        }
+    }
+
+    void reset ( ) noexcept { release ( std::exchange ( m_data, nullptr ) ); }
+
+    [[nodiscard]] bool is_released ( ) const noexcept { return not m_data; }
+
+    // The number of handles sharing the block, zero if released.
+    [[nodiscard]] size_type use_count ( ) const noexcept {
+        return m_data ? params_ref ( ).count.load ( std::memory_order_acquire ) : 0;
+    }
+    [[nodiscard]] bool is_unique ( ) const noexcept { return 1 == use_count ( ); }
+    // Whether a copy shares the block, see the class comment.
+    [[nodiscard]] bool is_shareable ( ) const noexcept { return not m_data or not params_ref ( ).unshareable; }
+
+    // Give this handle its own copy of the block, if it is shared.
+    void detach ( ) {
+        if ( m_data and not is_unique ( ) )
+            copy_block ( capacity_ref ( ) );
+    }
+
+    void reserve ( size_type cap_ ) {
+        cap_ = std::min ( max_allocation_size, cap_ ); // clamp.
+        if ( m_data ) {
+            if ( not is_unique ( ) )
+                copy_block ( std::max ( cap_, capacity_ref ( ) ) );
+            else if ( cap_ > capacity_ref ( ) )
+                cv_realloc ( cap_ );
+        }
+        else {
+            cv_malloc ( cap_ );
+        }
+    }
+
+    void resize ( size_type new_size_ = 0 ) {
+        size_type const old_size = size ( ); // Zero if not cv_malloc'ed.
+        if ( m_data ) {
+            detach ( );
+            if ( new_size_ < old_size ) {
+                std::for_each ( m_data + new_size_, m_data + old_size, [] ( value_type & value_ref ) { value_ref.~Type ( ); } );
+                size_ref ( ) = new_size_;
+                return;
+            }
+            if ( new_size_ > capacity_ref ( ) )
+                cv_realloc ( new_size_ );
+            size_ref ( ) = new_size_;
+        }
+        else {
+            cv_malloc ( new_size_, new_size_ );
+        }
+        std::for_each ( m_data + old_size, m_data + new_size_,
+                        [] ( value_type & value_ref ) { new ( &value_ref ) value_type{ }; } );
+    }
+
+    // Access.
+
+    [[nodiscard]] const_reference front ( ) const noexcept {
+        assert ( size ( ) );
+        return m_data[ 0 ];
+    }
+    [[nodiscard]] reference front ( ) {
+        leak ( );
+        return const_cast<reference> ( std::as_const ( *this ).front ( ) );
+    }
+
+    [[nodiscard]] const_reference back ( ) const noexcept {
+        assert ( size ( ) );
+        return m_data[ size_ref ( ) - size_type{ 1 } ];
+    }
+    [[nodiscard]] reference back ( ) {
+        leak ( );
+        return const_cast<reference> ( std::as_const ( *this ).back ( ) );
+    }
+
+    [[nodiscard]] const_reference at ( size_type const i_ ) const {
+        if ( i_ < size_type{ 0 } )
+            throw std::runtime_error ( "compact_cow_vector access error: negative index" );
+        if ( i_ >= size ( ) )
+            throw std::runtime_error ( "compact_cow_vector access error: index too large" );
+        return m_data[ i_ ];
+    }
+    [[nodiscard]] reference at ( size_type const i_ ) {
+        static_cast<void> ( std::as_const ( *this ).at ( i_ ) ); // Throw before detaching.
+        leak ( );
+        return m_data[ i_ ];
+    }
+
+    [[nodiscard]] const_reference operator[] ( size_type const i_ ) const noexcept {
+        assert ( not( i_ < size_type{ 0 } ) );
+        assert ( not( i_ >= size ( ) ) );
+        return m_data[ i_ ];
+    }
+    [[nodiscard]] reference operator[] ( size_type const i_ ) {
+        leak ( );
+        return const_cast<reference> ( std::as_const ( *this ).operator[] ( i_ ) );
+    }
+
+    // Compare for equality, a released vector compares equal to an empty one.
+
+    [[nodiscard]] bool operator== ( compact_cow_vector const & rhs_ ) const noexcept {
+        if ( m_data == rhs_.m_data ) // includes comparing 2 nullptrs and shared blocks.
+            return true;
+        size_type const s = size ( );
+        if ( s != rhs_.size ( ) )
+            return false;
+        if ( not s )
+            return true;
+        return std::equal ( begin ( ), end ( ), rhs_.begin ( ), rhs_.end ( ) );
+    }
+    [[nodiscard]] bool operator!= ( compact_cow_vector const & rhs_ ) const noexcept { return not operator== ( rhs_ ); }
+
+    // Data.
+
+    [[nodiscard]] const_pointer data ( ) const noexcept { return m_data; }
+    [[nodiscard]] pointer data ( ) {
+        leak ( );
+        return m_data;
+    }
+
+    // Iterators.
+
+    [[nodiscard]] const_iterator begin ( ) const noexcept {
+        assert ( m_data );
+        return const_iterator{ m_data };
+    }
+    [[nodiscard]] const_iterator cbegin ( ) const noexcept { return begin ( ); }
+    [[nodiscard]] iterator begin ( ) {
+        leak ( );
+        return const_cast<iterator> ( std::as_const ( *this ).begin ( ) );
+    }
+
+    [[nodiscard]] const_iterator end ( ) const noexcept {
+        assert ( m_data );
+        return const_iterator{ m_data + size_ref ( ) };
+    }
+    [[nodiscard]] const_iterator cend ( ) const noexcept { return end ( ); }
+    [[nodiscard]] iterator end ( ) {
+        leak ( );
+        return const_cast<iterator> ( std::as_const ( *this ).end ( ) );
+    }
+
+    // Sizes.
+
+    [[nodiscard]] static constexpr size_type max_size ( ) noexcept { return max_allocation_size; }
+
+    [[nodiscard]] size_type capacity ( ) const noexcept { return m_data ? capacity_ref ( ) : 0; }
+    [[nodiscard]] size_type size ( ) const noexcept { return m_data ? size_ref ( ) : 0; }
+
+    [[nodiscard]] bool empty ( ) const noexcept { return not m_data or not size_ref ( ); }
+
+    // Emplace/Pop.
+
+    template<typename... Args>
+    void emplace_back ( Args &&... args_ ) {
+        if ( m_data ) { // not allocate, maybe relocate.
+            if ( not is_unique ( ) )
+                copy_block ( size_ref ( ) == capacity_ref ( ) ? grow_capacity ( capacity_ref ( ) ) : capacity_ref ( ) );
+            else if ( size_ref ( ) == capacity_ref ( ) ) // relocate.
+                cv_realloc ( grow_capacity ( capacity_ref ( ) ) );
+            assert ( size ( ) < capacity ( ) );
+            new ( m_data + size_ref ( )++ ) value_type{ std::forward<Args> ( args_ )... };
+        }
+        else { // allocate.
+            new ( cv_malloc ( default_allocation_size, 1 ) ) value_type{ std::forward<Args> ( args_ )... };
+        }
+    }
+
+    void push_back ( const_reference v_ ) { emplace_back ( value_type{ v_ } ); }
+
+    void pop_back ( ) {
+        assert ( size ( ) );
+        detach ( );
+        m_data[ --size_ref ( ) ].~Type ( );
+    }
+
+    // Swap.
+
+    void swap ( compact_cow_vector & rhs_ ) noexcept { std::swap ( m_data, rhs_.m_data ); }
+
+    // Output.
+
+    template<typename Stream>
+    [[maybe_unused]] friend Stream & operator<< ( Stream & out_, compact_cow_vector const & m_ ) noexcept {
+        if ( m_.data ( ) )
+            for ( auto const & e : m_ )
+                out_ << e << sp; // A wide- or narrow-string space, as appropriate.
+        return out_;
+    }
+
+    private:
+    [[nodiscard]] static params & params_of ( pointer p_ ) noexcept {
+        assert ( p_ );
+        return *reinterpret_cast<params *> ( reinterpret_cast<char *> ( p_ ) - sizeof ( params ) );
+    }
+
+    [[nodiscard]] static pointer acquire ( pointer p_ ) noexcept {
+        if ( p_ )
+            params_of ( p_ ).count.fetch_add ( 1, std::memory_order_relaxed );
+        return p_;
+    }
+
+    // Drop a reference, the last one out destroys the values and frees the block.
+    static void release ( pointer p_ ) noexcept {
+        if ( p_ and 1 == params_of ( p_ ).count.fetch_sub ( 1, std::memory_order_acq_rel ) ) {
+            std::for_each ( p_, p_ + params_of ( p_ ).size, [] ( value_type & value_ref ) { value_ref.~Type ( ); } );
+            params_of ( p_ ).~params ( );
+            detail::cv::free ( reinterpret_cast<char *> ( p_ ) - sizeof ( params ) );
+        }
+    }
+
+    // Detach and mark the block unshareable, before handing out a mutable reference into it.
+    void leak ( ) {
+        detach ( );
+        if ( m_data )
+            params_ref ( ).unshareable = true;
+    }
+
+    // Make this the handle of a new block with capacity cap_, which must be at least the size of p_,
+    // holding a copy of the values of p_.
+    void copy_from ( pointer p_, size_type cap_ ) {
+        size_type const sz = params_of ( p_ ).size;
+        assert ( cap_ >= sz );
+        m_data = nullptr;
+        cv_malloc ( cap_, 0 );
+        std::uninitialized_copy ( p_, p_ + sz, m_data );
+        size_ref ( ) = sz;
+    }
+
+    // Replace the (shared) block by an unshared copy with capacity cap_, which must be at least size.
+    void copy_block ( size_type cap_ ) {
+        pointer const p = m_data;
+        copy_from ( p, cap_ );
+        release ( p );
+    }
+
+    // Only valid for an unshared block.
+    [[maybe_unused]] pointer cv_realloc ( size_type cap_ ) {
+        assert ( is_unique ( ) );
+        m_data = ptr_mem ( detail::cv::realloc ( mem_ptr ( m_data ), sizeof ( params ) + cap_ * sizeof ( value_type ) ) );
+        capacity_ref ( )           = cap_;
+        params_ref ( ).unshareable = false; // The references have been invalidated.
+        return m_data;
+    }
+
+    [[maybe_unused]] pointer cv_malloc ( size_type cap_, size_type siz_ = 0 ) {
+        void_ptr const mem = detail::cv::malloc ( sizeof ( params ) + cap_ * sizeof ( value_type ) );
+        return m_data      = ptr_mem ( new ( mem ) params{ { 1 }, cap_, siz_, false } );
+    }
+
+    // The MSVC-growth strategy for std::vector.
+    [[nodiscard]] static size_type grow_capacity ( size_type c_ ) noexcept {
+        return c_ > 1 ? std::min ( max_allocation_size, c_ + c_ / 2 ) : size_type{ 2 };
+    }
+
+    [[nodiscard]] inline params const & params_ref ( ) const noexcept { return params_of ( m_data ); }
+    [[nodiscard]] inline size_type const & capacity_ref ( ) const noexcept { return params_ref ( ).capacity; }
+    [[nodiscard]] inline size_type const & size_ref ( ) const noexcept { return params_ref ( ).size; }
+
+    [[nodiscard]] inline params & params_ref ( ) noexcept { return params_of ( m_data ); }
+    [[nodiscard]] inline size_type & capacity_ref ( ) noexcept { return params_ref ( ).capacity; }
+    [[nodiscard]] inline size_type & size_ref ( ) noexcept { return params_ref ( ).size; }
+
+    [[nodiscard]] inline void_ptr mem_ptr ( pointer mem_ ) const noexcept {
+        assert ( mem_ );
+        return reinterpret_cast<void_ptr> ( reinterpret_cast<char *> ( mem_ ) - sizeof ( params ) );
+    }
+    [[nodiscard]] inline pointer ptr_mem ( void_ptr ptr_ ) const noexcept {
+        assert ( ptr_ );
+        return reinterpret_cast<pointer> ( reinterpret_cast<char *> ( ptr_ ) + sizeof ( params ) );
+    }
+
+    // Pointer alignment.
+    pointer m_data = nullptr;
+};
+
+} // namespace sax
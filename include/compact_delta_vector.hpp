@@ -0,0 +1,612 @@
+// MIT License
+//
+// Copyright (c) 2020 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "compact_vector.hpp"
+
+#if defined( __SSE2__ ) or defined( _M_X64 ) or ( defined( _M_IX86_FP ) and _M_IX86_FP >= 2 )
+#    define COMPACT_DELTA_VECTOR_SSE2 true
+#    include <emmintrin.h>
+#else
+#    define COMPACT_DELTA_VECTOR_SSE2 false
+#endif
+
+namespace sax {
+
+namespace detail::cv {
+
+template<typename Type, typename SizeType = int>
+struct delta_params {
+
+    using value_type    = Type;
+    using pointer       = value_type *;
+    using const_pointer = value_type const *;
+
+    using size_type = SizeType;
+
+    size_type capacity, length, tail, size; // capacity and length of the packed blocks in words, tail in bytes.
+    value_type first, last;                 // The first value is the base of the deltas of the first block.
+};
+
+// Blocks of 128 deltas are bit-packed in the SIMD-BP128 layout, i.e. the deltas are distributed
+// round-robin over the lanes of a 128-bit register and each lane is packed at the same bit width,
+// so that every step of (un)packing applies the same shift and mask to all lanes. With SSE2, 32- and
+// 64-bit words are (un)packed a register at a time, with a register prefix sum on decode, other word
+// sizes take the scalar path.
+
+inline constexpr std::size_t delta_block_size = 128;
+
+template<typename Type>
+inline constexpr std::size_t delta_lanes = 16 / sizeof ( Type );
+
+// A lane holds word_bits values, packed at bits_ they occupy bits_ words, a block lanes * bits_ words.
+template<typename Type>
+inline constexpr std::size_t delta_word_bits = std::numeric_limits<Type>::digits;
+
+#if COMPACT_DELTA_VECTOR_SSE2
+
+template<typename Type>
+inline constexpr bool has_sse2_delta_v = sizeof ( Type ) == 4 or sizeof ( Type ) == 8;
+
+// Shift (by a count shared by all lanes), add and broadcast the last lane, for 32- or 64-bit lanes.
+
+template<typename Type>
+[[nodiscard]] inline __m128i sse2_srl ( __m128i const v_, int const n_ ) noexcept {
+    if constexpr ( sizeof ( Type ) == 4 )
+        return _mm_srl_epi32 ( v_, _mm_cvtsi32_si128 ( n_ ) );
+    else
+        return _mm_srl_epi64 ( v_, _mm_cvtsi32_si128 ( n_ ) );
+}
+template<typename Type>
+[[nodiscard]] inline __m128i sse2_sll ( __m128i const v_, int const n_ ) noexcept {
+    if constexpr ( sizeof ( Type ) == 4 )
+        return _mm_sll_epi32 ( v_, _mm_cvtsi32_si128 ( n_ ) );
+    else
+        return _mm_sll_epi64 ( v_, _mm_cvtsi32_si128 ( n_ ) );
+}
+template<typename Type>
+[[nodiscard]] inline __m128i sse2_add ( __m128i const a_, __m128i const b_ ) noexcept {
+    if constexpr ( sizeof ( Type ) == 4 )
+        return _mm_add_epi32 ( a_, b_ );
+    else
+        return _mm_add_epi64 ( a_, b_ );
+}
+template<typename Type>
+[[nodiscard]] inline __m128i sse2_broadcast_last ( __m128i const v_ ) noexcept {
+    if constexpr ( sizeof ( Type ) == 4 )
+        return _mm_shuffle_epi32 ( v_, _MM_SHUFFLE ( 3, 3, 3, 3 ) );
+    else
+        return _mm_shuffle_epi32 ( v_, _MM_SHUFFLE ( 3, 2, 3, 2 ) );
+}
+
+// Inclusive prefix sum of the lanes of v_, plus the broadcast running total base_.
+template<typename Type>
+[[nodiscard]] inline __m128i sse2_prefix_sum ( __m128i v_, __m128i const base_ ) noexcept {
+    if constexpr ( sizeof ( Type ) == 4 )
+        v_ = _mm_add_epi32 ( v_, _mm_slli_si128 ( v_, 4 ) );
+    v_ = sse2_add<Type> ( v_, _mm_slli_si128 ( v_, 8 ) );
+    return sse2_add<Type> ( v_, base_ );
+}
+
+#endif
+
+template<typename Type>
+void pack_block ( Type const * __restrict in_, unsigned const bits_, Type * __restrict out_ ) noexcept {
+    constexpr std::size_t lanes = delta_lanes<Type>, word_bits = delta_word_bits<Type>;
+#if COMPACT_DELTA_VECTOR_SSE2
+    if constexpr ( has_sse2_delta_v<Type> ) {
+        if ( not bits_ )
+            return;
+        __m128i const * const in = reinterpret_cast<__m128i const *> ( in_ );
+        __m128i * const out      = reinterpret_cast<__m128i *> ( out_ );
+        __m128i acc              = _mm_setzero_si128 ( );
+        for ( std::size_t k = 0, bit = 0; k < word_bits; ++k, bit += bits_ ) {
+            std::size_t const off = bit % word_bits;
+            __m128i const v       = _mm_loadu_si128 ( in + k );
+            acc                   = _mm_or_si128 ( acc, sse2_sll<Type> ( v, static_cast<int> ( off ) ) );
+            if ( off + bits_ >= word_bits ) { // The word is complete.
+                _mm_storeu_si128 ( out + bit / word_bits, acc );
+                acc = off + bits_ > word_bits ? sse2_srl<Type> ( v, static_cast<int> ( word_bits - off ) ) : _mm_setzero_si128 ( );
+            }
+        }
+        return;
+    }
+#endif
+    std::fill ( out_, out_ + lanes * bits_, Type{ 0 } );
+    for ( std::size_t k = 0, bit = 0; k < word_bits; ++k, bit += bits_ ) {
+        std::size_t const w  = bit / word_bits, off = bit % word_bits;
+        Type * const o       = out_ + w * lanes;
+        Type const * const i = in_ + k * lanes;
+        for ( std::size_t l = 0; l < lanes; ++l )
+            o[ l ] |= static_cast<Type> ( i[ l ] << off );
+        if ( off + bits_ > word_bits )
+            for ( std::size_t l = 0; l < lanes; ++l )
+                o[ lanes + l ] |= static_cast<Type> ( i[ l ] >> ( word_bits - off ) );
+    }
+}
+
+// Unpack the deltas and turn them into values by a prefix sum starting at base_.
+template<typename Type>
+void unpack_block ( Type const * __restrict in_, unsigned const bits_, Type base_, Type * __restrict out_ ) noexcept {
+    constexpr std::size_t lanes = delta_lanes<Type>, word_bits = delta_word_bits<Type>;
+    if ( not bits_ ) {
+        std::fill ( out_, out_ + delta_block_size, base_ );
+        return;
+    }
+    Type const mask = bits_ == word_bits ? static_cast<Type> ( ~Type{ 0 } ) : static_cast<Type> ( ( Type{ 1 } << bits_ ) - 1u );
+#if COMPACT_DELTA_VECTOR_SSE2
+    if constexpr ( has_sse2_delta_v<Type> ) {
+        __m128i const * const in = reinterpret_cast<__m128i const *> ( in_ );
+        __m128i * const out      = reinterpret_cast<__m128i *> ( out_ );
+        __m128i const m          = sizeof ( Type ) == 4 ? _mm_set1_epi32 ( static_cast<int> ( mask ) )
+                                                        : _mm_set1_epi64x ( static_cast<long long> ( mask ) );
+        __m128i base = sizeof ( Type ) == 4 ? _mm_set1_epi32 ( static_cast<int> ( base_ ) )
+                                            : _mm_set1_epi64x ( static_cast<long long> ( base_ ) );
+        for ( std::size_t k = 0, bit = 0; k < word_bits; ++k, bit += bits_ ) {
+            std::size_t const w = bit / word_bits, off = bit % word_bits;
+            __m128i v           = sse2_srl<Type> ( _mm_loadu_si128 ( in + w ), static_cast<int> ( off ) );
+            if ( off + bits_ > word_bits )
+                v = _mm_or_si128 ( v, sse2_sll<Type> ( _mm_loadu_si128 ( in + w + 1 ), static_cast<int> ( word_bits - off ) ) );
+            v = sse2_prefix_sum<Type> ( _mm_and_si128 ( v, m ), base ); // The lanes hold consecutive deltas.
+            _mm_storeu_si128 ( out + k, v );
+            base = sse2_broadcast_last<Type> ( v );
+        }
+        return;
+    }
+#endif
+    for ( std::size_t k = 0, bit = 0; k < word_bits; ++k, bit += bits_ ) {
+        std::size_t const w  = bit / word_bits, off = bit % word_bits;
+        Type const * const i = in_ + w * lanes;
+        Type * const o       = out_ + k * lanes;
+        for ( std::size_t l = 0; l < lanes; ++l )
+            o[ l ] = static_cast<Type> ( i[ l ] >> off );
+        if ( off + bits_ > word_bits )
+            for ( std::size_t l = 0; l < lanes; ++l )
+                o[ l ] |= static_cast<Type> ( i[ lanes + l ] << ( word_bits - off ) );
+        for ( std::size_t l = 0; l < lanes; ++l )
+            o[ l ] &= mask;
+    }
+    for ( std::size_t i = 0; i < delta_block_size; ++i )
+        out_[ i ] = base_ = static_cast<Type> ( base_ + out_[ i ] );
+}
+
+// The values appended after the last full block are kept as a tail of LEB128 varint deltas, i.e. 7 bits
+// per byte, with the high bit flagging a continuation.
+
+template<typename Type>
+inline constexpr std::size_t varint_max_bytes = ( std::numeric_limits<Type>::digits + 6 ) / 7;
+
+template<typename Type>
+[[nodiscard]] inline unsigned char * encode_varint ( Type v_, unsigned char * out_ ) noexcept {
+    while ( v_ >= 0x80u ) {
+        *out_++ = static_cast<unsigned char> ( v_ | 0x80u );
+        v_      = static_cast<Type> ( v_ >> 7 );
+    }
+    *out_++ = static_cast<unsigned char> ( v_ );
+    return out_;
+}
+
+template<typename Type>
+[[nodiscard]] inline unsigned char const * decode_varint ( unsigned char const * in_, Type & v_ ) noexcept {
+    Type v         = 0;
+    unsigned shift = 0;
+    for ( ; *in_ & 0x80u; shift += 7 )
+        v = static_cast<Type> ( v | static_cast<Type> ( *in_++ & 0x7Fu ) << shift );
+    v_ = static_cast<Type> ( v | static_cast<Type> ( *in_++ ) << shift );
+    return in_;
+}
+
+// Decode n_ varint deltas and turn them into values by a prefix sum starting at base_.
+template<typename Type>
+void decode_varints ( unsigned char const * in_, std::size_t n_, Type base_, Type * out_ ) noexcept {
+    for ( Type d; n_; --n_ ) {
+        in_     = decode_varint ( in_, d );
+        *out_++ = base_ = static_cast<Type> ( base_ + d );
+    }
+}
+
+} // namespace detail::cv
+
+// A sorted sequence of unsigned integers, stored delta-encoded behind a single pointer. Full blocks of
+// 128 values are bit-packed, each preceded by its last value and its bit width, which act as skip
+// pointers for lower_bound ( ) and const_iterator::skip_to ( ). The first value is kept in the header
+// and is the base of the deltas of the first block. The values appended after the last full block are
+// kept as varint deltas, until the block fills up.
+template<typename Type, typename SizeType = int>
+class compact_delta_vector {
+
+    public:
+    using value_type    = Type;
+    using pointer       = value_type *;
+    using const_pointer = value_type const *;
+
+    using const_reference = value_type const &;
+
+    using size_type       = SizeType;
+    using difference_type = std::make_signed_t<size_type>;
+
+    using void_ptr = void *;
+    using params   = detail::cv ::delta_params<value_type, size_type>;
+
+    static_assert ( std::is_unsigned_v<value_type> and not std::is_same_v<value_type, bool>,
+                    "Value type must be an unsigned integer type" );
+
+    static constexpr size_type block_size = static_cast<size_type> ( detail::cv::delta_block_size );
+
+    private:
+    static constexpr size_type lanes = static_cast<size_type> ( detail::cv::delta_lanes<value_type> );
+
+    // The words to reserve for appending a varint.
+    static constexpr size_type varint_words =
+        static_cast<size_type> ( ( detail::cv::varint_max_bytes<value_type> + sizeof ( value_type ) - 1 ) / sizeof ( value_type ) );
+
+    public:
+    // Iterators.
+
+    // A single pass input iterator, which decodes a block at a time into a buffer it owns, values are
+    // returned by value, as they do not outlive the iterator. Postfix increment returns void, to avoid
+    // copying the buffer, copy the iterator explicitly where needed (which copies 0.5 - 1 KiB).
+    class const_iterator {
+
+        friend class compact_delta_vector;
+
+        public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = Type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = value_type;
+
+        const_iterator ( ) noexcept = default;
+
+        [[nodiscard]] reference operator* ( ) const noexcept {
+            assert ( m_pos < m_count );
+            return m_buffer[ m_pos ];
+        }
+
+        [[maybe_unused]] const_iterator & operator++ ( ) noexcept {
+            ++m_index;
+            if ( ++m_pos == m_count )
+                load ( );
+            return *this;
+        }
+        void operator++ ( int ) noexcept { ++*this; }
+
+        // Advance to the first value not less than v_, from the current position on, so that intersecting
+        // sorted lists takes a single pass over each. Whole blocks are skipped on their last value, only
+        // the block containing the result is decoded.
+        [[maybe_unused]] const_iterator & skip_to ( value_type const v_ ) noexcept {
+            if ( m_index == m_size or m_buffer[ m_count - 1 ] >= v_ ) {
+                find ( v_ );
+            }
+            else {
+                m_index += m_count - m_pos; // The start of the next block.
+                seek ( v_ );
+            }
+            return *this;
+        }
+
+        [[nodiscard]] bool operator== ( const_iterator const & rhs_ ) const noexcept { return m_index == rhs_.m_index; }
+        [[nodiscard]] bool operator== ( std::default_sentinel_t ) const noexcept { return m_index == m_size; }
+
+        // The position in the sequence.
+        [[nodiscard]] size_type index ( ) const noexcept { return m_index; }
+
+        private:
+        const_iterator ( compact_delta_vector const & cdv_ ) noexcept :
+            m_next{ cdv_.m_data }, m_size{ cdv_.size ( ) }, m_blocks{ cdv_.size ( ) / block_size },
+            m_base{ cdv_.m_data ? cdv_.params_ref ( ).first : value_type{ 0 } } {}
+
+        // Decode the next packed block, or the tail, into the buffer.
+        void load ( ) noexcept {
+            m_pos = 0;
+            if ( m_blocks ) {
+                detail::cv::unpack_block ( m_next + 2, static_cast<unsigned> ( m_next[ 1 ] ), m_base, m_buffer );
+                m_base = m_next[ 0 ];
+                m_next += 2 + lanes * static_cast<size_type> ( m_next[ 1 ] );
+                m_count = block_size;
+                --m_blocks;
+            }
+            else {
+                m_count = m_size - m_index;
+                detail::cv::decode_varints ( reinterpret_cast<unsigned char const *> ( m_next ),
+                                             static_cast<std::size_t> ( m_count ), m_base, m_buffer );
+            }
+        }
+
+        // From the start of a block, skip the blocks ending before v_, load the next and find v_ in it.
+        void seek ( value_type const v_ ) noexcept {
+            while ( m_blocks and m_next[ 0 ] < v_ ) {
+                m_base = m_next[ 0 ];
+                m_next += 2 + lanes * static_cast<size_type> ( m_next[ 1 ] );
+                m_index += block_size;
+                --m_blocks;
+            }
+            load ( );
+            find ( v_ );
+        }
+
+        // Find v_ in the buffer, from the current position on, not finding it in the tail is the end.
+        void find ( value_type const v_ ) noexcept {
+            size_type const pos =
+                static_cast<size_type> ( std::lower_bound ( m_buffer + m_pos, m_buffer + m_count, v_ ) - m_buffer );
+            m_index += pos - m_pos;
+            m_pos = pos;
+        }
+
+        const_pointer m_next = nullptr;
+        size_type m_size = 0, m_blocks = 0, m_index = 0, m_pos = 0, m_count = 0;
+        value_type m_base = 0;
+        value_type m_buffer[ detail::cv::delta_block_size ];
+    };
+
+    // Construct.
+
+    explicit compact_delta_vector ( ) noexcept {}
+    compact_delta_vector ( compact_delta_vector const & cdv_ ) {
+        if ( cdv_.m_data ) {
+            size_type const words = cdv_.used_words ( );
+            cv_malloc ( words );
+            std::memcpy ( mem_ptr ( m_data ), cdv_.mem_ptr ( cdv_.m_data ), sizeof ( params ) + words * sizeof ( value_type ) );
+            capacity_ref ( ) = words;
+        }
+    }
+    compact_delta_vector ( compact_delta_vector && cdv_ ) noexcept : m_data{ std::exchange ( cdv_.m_data, nullptr ) } {}
+
+    ~compact_delta_vector ( ) noexcept { reset ( ); }
+
+    // Assignment.
+
+    [[maybe_unused]] compact_delta_vector & operator= ( compact_delta_vector const & rhs_ ) {
+        if ( this != &rhs_ )
+            compact_delta_vector{ rhs_ }.swap ( *this );
+        return *this;
+    }
+
+    [[maybe_unused]] compact_delta_vector & operator= ( compact_delta_vector && rhs_ ) noexcept {
+        if ( this != &rhs_ ) {
+            reset ( );
+            m_data = std::exchange ( rhs_.m_data, nullptr );
+        }
+        return *this;
+    }
+
+    // Manage.
+
+    void clear ( ) noexcept {
+        if ( m_data )
+            params_ref ( ) = { capacity_ref ( ), 0, 0, 0, 0, 0 };
+    }
+
+    void reset ( ) noexcept {
+        if ( m_data )
+            detail::cv::free ( mem_ptr ( m_data ) );
+        m_data = nullptr;
+    }
+
+    // Release the capacity not in use.
+    void shrink_to_fit ( ) {
+        if ( m_data and capacity_ref ( ) > used_words ( ) )
+            cv_realloc ( used_words ( ) );
+    }
+
+    [[nodiscard]] bool is_released ( ) const noexcept { return not m_data; }
+
+    // Append.
+
+    void push_back ( value_type const v_ ) {
+        assert ( empty ( ) or v_ >= back ( ) );
+        reserve_words ( varint_words );
+        params & p = params_ref ( );
+        if ( not p.size )
+            p.first = p.last = v_;
+        unsigned char * const tail = reinterpret_cast<unsigned char *> ( m_data + p.length );
+        p.tail =
+            static_cast<size_type> ( detail::cv::encode_varint ( static_cast<value_type> ( v_ - p.last ), tail + p.tail ) - tail );
+        p.last = v_;
+        if ( not( ++p.size % block_size ) )
+            pack_tail ( );
+    }
+
+    // Access.
+
+    [[nodiscard]] value_type back ( ) const noexcept {
+        assert ( size ( ) );
+        return params_ref ( ).last;
+    }
+
+    [[nodiscard]] const_iterator begin ( ) const noexcept {
+        const_iterator it{ *this };
+        it.load ( );
+        return it;
+    }
+    [[nodiscard]] const_iterator cbegin ( ) const noexcept { return begin ( ); }
+
+    [[nodiscard]] std::default_sentinel_t end ( ) const noexcept { return std::default_sentinel; }
+    [[nodiscard]] std::default_sentinel_t cend ( ) const noexcept { return end ( ); }
+
+    // The first value not less than v_. Whole blocks are skipped on their last value, only the block
+    // containing the result is decoded. For repeated seeks, as in intersecting lists, continue from the
+    // result with const_iterator::skip_to ( ).
+    [[nodiscard]] const_iterator lower_bound ( value_type const v_ ) const noexcept {
+        const_iterator it{ *this };
+        it.seek ( v_ );
+        return it;
+    }
+
+    [[nodiscard]] bool contains ( value_type const v_ ) const noexcept {
+        const_iterator const it = lower_bound ( v_ );
+        return it != end ( ) and *it == v_;
+    }
+
+    // Decode all values into out_, which must have space for size ( ) values.
+    [[maybe_unused]] pointer decode ( pointer out_ ) const noexcept {
+        if ( m_data ) {
+            const_pointer p = m_data;
+            value_type base = params_ref ( ).first;
+            for ( size_type b = size_ref ( ) / block_size; b; --b, out_ += block_size ) {
+                detail::cv::unpack_block ( p + 2, static_cast<unsigned> ( p[ 1 ] ), base, out_ );
+                base = p[ 0 ];
+                p += 2 + lanes * static_cast<size_type> ( p[ 1 ] );
+            }
+            size_type const n = size_ref ( ) % block_size;
+            detail::cv::decode_varints ( reinterpret_cast<unsigned char const *> ( p ), static_cast<std::size_t> ( n ), base,
+                                         out_ );
+            out_ += n;
+        }
+        return out_;
+    }
+
+    // Compare for equality, the encoding is unique, so this compares the streams.
+
+    [[nodiscard]] bool operator== ( compact_delta_vector const & rhs_ ) const noexcept {
+        if ( m_data == rhs_.m_data ) // includes comparing 2 nullptrs.
+            return true;
+        if ( size ( ) != rhs_.size ( ) )
+            return false;
+        if ( empty ( ) )
+            return true;
+        params const &l = params_ref ( ), &r = rhs_.params_ref ( );
+        std::size_t const n = static_cast<std::size_t> ( l.length ) * sizeof ( value_type ) + static_cast<std::size_t> ( l.tail );
+        return l.first == r.first and l.length == r.length and l.tail == r.tail and not std::memcmp ( m_data, rhs_.m_data, n );
+    }
+    [[nodiscard]] bool operator!= ( compact_delta_vector const & rhs_ ) const noexcept { return not operator== ( rhs_ ); }
+
+    // Sizes.
+
+    [[nodiscard]] size_type size ( ) const noexcept { return m_data ? size_ref ( ) : 0; }
+    [[nodiscard]] bool empty ( ) const noexcept { return not m_data or not size_ref ( ); }
+
+    // The size of the allocated block in bytes, including the capacity not in use.
+    [[nodiscard]] std::size_t bytes ( ) const noexcept {
+        return m_data ? sizeof ( params ) + static_cast<std::size_t> ( capacity_ref ( ) ) * sizeof ( value_type ) : 0;
+    }
+
+    // Swap.
+
+    void swap ( compact_delta_vector & rhs_ ) noexcept { std::swap ( m_data, rhs_.m_data ); }
+
+    // Output.
+
+    template<typename Stream>
+    [[maybe_unused]] friend Stream & operator<< ( Stream & out_, compact_delta_vector const & m_ ) noexcept {
+        for ( auto const e : m_ )
+            out_ << e << sp; // A wide- or narrow-string space, as appropriate.
+        return out_;
+    }
+
+    private:
+    // Bit-pack the (full) tail of varint deltas, the packed block replaces the tail in the stream.
+    void pack_tail ( ) {
+        value_type deltas[ detail::cv::delta_block_size ];
+        unsigned char const * tail = reinterpret_cast<unsigned char const *> ( m_data + length_ref ( ) );
+        value_type acc             = 0;
+        for ( value_type & d : deltas ) {
+            tail = detail::cv::decode_varint ( tail, d );
+            acc |= d;
+        }
+        unsigned const bits = static_cast<unsigned> ( std::bit_width ( acc ) );
+        tail_ref ( )        = 0;
+        reserve_words ( 2 + lanes * static_cast<size_type> ( bits ) );
+        pointer const o = m_data + length_ref ( );
+        o[ 0 ]          = params_ref ( ).last;
+        o[ 1 ]          = static_cast<value_type> ( bits );
+        detail::cv::pack_block ( deltas, bits, o + 2 );
+        length_ref ( ) += 2 + lanes * static_cast<size_type> ( bits );
+    }
+
+    // The words in use, the packed blocks and the tail, rounded up.
+    [[nodiscard]] size_type used_words ( ) const noexcept {
+        std::size_t const tail = static_cast<std::size_t> ( tail_ref ( ) );
+        return length_ref ( ) + static_cast<size_type> ( ( tail + sizeof ( value_type ) - 1 ) / sizeof ( value_type ) );
+    }
+
+    // Make room for n_ more words in the stream, growing the capacity the MSVC-way.
+    void reserve_words ( size_type const n_ ) {
+        if ( m_data ) {
+            size_type const required = used_words ( ) + n_;
+            if ( required > capacity_ref ( ) ) {
+                size_type const c = capacity_ref ( );
+                cv_realloc ( std::max ( required, c + c / 2 ) );
+            }
+        }
+        else {
+            cv_malloc ( std::max ( n_, size_type{ 2 } ) );
+        }
+    }
+
+    [[maybe_unused]] pointer cv_realloc ( size_type cap_ ) {
+        m_data = ptr_mem ( detail::cv::realloc ( mem_ptr ( m_data ), sizeof ( params ) + cap_ * sizeof ( value_type ) ) );
+        capacity_ref ( ) = cap_;
+        return m_data;
+    }
+
+    [[maybe_unused]] pointer cv_malloc ( size_type cap_ ) {
+        void_ptr const mem = detail::cv::malloc ( sizeof ( params ) + cap_ * sizeof ( value_type ) );
+        return m_data      = ptr_mem ( new ( mem ) params{ cap_, 0, 0, 0, 0, 0 } );
+    }
+
+    [[nodiscard]] inline params const & params_ref ( ) const noexcept {
+        assert ( m_data );
+        return *reinterpret_cast<params const *> ( reinterpret_cast<char const *> ( m_data ) - sizeof ( params ) );
+    }
+    [[nodiscard]] inline size_type const & capacity_ref ( ) const noexcept { return params_ref ( ).capacity; }
+    [[nodiscard]] inline size_type const & length_ref ( ) const noexcept { return params_ref ( ).length; }
+    [[nodiscard]] inline size_type const & tail_ref ( ) const noexcept { return params_ref ( ).tail; }
+    [[nodiscard]] inline size_type const & size_ref ( ) const noexcept { return params_ref ( ).size; }
+
+    [[nodiscard]] inline params & params_ref ( ) noexcept {
+        return const_cast<params &> ( std::as_const ( *this ).params_ref ( ) );
+    }
+    [[nodiscard]] inline size_type & capacity_ref ( ) noexcept { return params_ref ( ).capacity; }
+    [[nodiscard]] inline size_type & length_ref ( ) noexcept { return params_ref ( ).length; }
+    [[nodiscard]] inline size_type & tail_ref ( ) noexcept { return params_ref ( ).tail; }
+    [[nodiscard]] inline size_type & size_ref ( ) noexcept { return params_ref ( ).size; }
+
+    [[nodiscard]] inline void_ptr mem_ptr ( pointer mem_ ) const noexcept {
+        assert ( mem_ );
+        return reinterpret_cast<void_ptr> ( reinterpret_cast<char *> ( mem_ ) - sizeof ( params ) );
+    }
+    [[nodiscard]] inline pointer ptr_mem ( void_ptr ptr_ ) const noexcept {
+        assert ( ptr_ );
+        return reinterpret_cast<pointer> ( reinterpret_cast<char *> ( ptr_ ) + sizeof ( params ) );
+    }
+
+    // Pointer alignment.
+    pointer m_data = nullptr;
+};
+
+} // namespace sax
@@ -0,0 +1,371 @@
+// MIT License
+//
+// Copyright (c) 2020 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "compact_vector.hpp"
+
+namespace sax {
+
+namespace detail::cv {
+
+// The SIMD register width in bytes, the default column alignment.
+#if defined( __AVX512F__ )
+inline constexpr std::size_t simd_alignment = 64;
+#elif defined( __AVX__ )
+inline constexpr std::size_t simd_alignment = 32;
+#else
+inline constexpr std::size_t simd_alignment = 16;
+#endif
+
+} // namespace detail::cv
+
+// A structure-of-arrays vector, one column per type in Ts, with all columns in a single block behind
+// a single pointer. The columns share one params header, i.e. size and capacity, and grow (relocate)
+// together. Every column starts on a column_alignment boundary, the pointer points at the first
+// column, with the header just in front of it. Each column is padded to the alignment, so for a
+// vector of a few rows, a small alignment keeps the block small.
+//
+//  [ padding | params ][ column 0 | padding ][ column 1 | padding ]...
+//                      ^ m_data
+template<typename SizeType, std::size_t Alignment, typename... Ts>
+class basic_compact_soa_vector {
+
+    public:
+    using value_type      = std::tuple<Ts...>;
+    using reference       = std::tuple<Ts &...>;
+    using const_reference = std::tuple<Ts const &...>;
+
+    template<std::size_t I>
+    using column_type = std::tuple_element_t<I, value_type>;
+
+    using size_type       = SizeType;
+    using difference_type = std::make_signed_t<size_type>;
+
+    using void_ptr = void *;
+    using params   = detail::cv ::params<value_type, size_type>;
+
+    static constexpr std::size_t columns = sizeof...( Ts );
+
+    static constexpr std::size_t column_alignment = std::max ( { Alignment, alignof ( Ts )... } );
+
+    static_assert ( columns > 0, "At least one column is required" );
+    static_assert ( std::has_single_bit ( Alignment ), "The alignment must be a power of 2" );
+
+    // Construct, the constructors delegate, such that the destructor cleans up if constructing the
+    // values throws.
+
+    explicit basic_compact_soa_vector ( ) noexcept {}
+    basic_compact_soa_vector ( size_type const size_ ) : basic_compact_soa_vector ( ) { resize ( size_ ); }
+    basic_compact_soa_vector ( basic_compact_soa_vector const & cv_ ) : basic_compact_soa_vector ( ) {
+        if ( cv_.m_data ) {
+            size_type const size = cv_.size_ref ( ), cap = cv_.capacity_ref ( );
+            m_data               = cv_malloc ( size );
+            construct_rows ( m_data, size, 0, size, [ this, &cv_, size, cap ] ( auto i_ ) {
+                auto const src = column_ptr<decltype ( i_ )::value> ( cv_.m_data, cap );
+                std::uninitialized_copy ( src, src + size, column_ptr<decltype ( i_ )::value> ( m_data, size ) );
+            } );
+            size_ref ( ) = size;
+        }
+    }
+    basic_compact_soa_vector ( basic_compact_soa_vector && cv_ ) noexcept : m_data{ std::exchange ( cv_.m_data, nullptr ) } {}
+
+    ~basic_compact_soa_vector ( ) noexcept { reset ( ); }
+
+    // Assignment.
+
+    [[maybe_unused]] basic_compact_soa_vector & operator= ( basic_compact_soa_vector const & rhs_ ) {
+        if ( this != &rhs_ )
+            basic_compact_soa_vector{ rhs_ }.swap ( *this );
+        return *this;
+    }
+
+    [[maybe_unused]] basic_compact_soa_vector & operator= ( basic_compact_soa_vector && rhs_ ) noexcept {
+        if ( this != &rhs_ ) {
+            reset ( );
+            m_data = std::exchange ( rhs_.m_data, nullptr );
+        }
+        return *this;
+    }
+
+    // Manage.
+
+    void clear ( ) noexcept {
+        if ( m_data ) {
+            destroy_rows ( 0, size_ref ( ) );
+            size_ref ( ) = 0;
+        }
+    }
+
+    void reset ( ) noexcept {
+        if ( m_data ) {
+            destroy_rows ( 0, size_ref ( ) );
+            cv_free ( m_data );
+            m_data = nullptr;
+        }
+    }
+
+    [[nodiscard]] bool is_released ( ) const noexcept { return not m_data; }
+
+    void reserve ( size_type cap_ ) {
+        cap_ = std::min ( max_size ( ), cap_ ); // clamp.
+        if ( cap_ > capacity ( ) or not m_data )
+            relocate ( cap_ );
+    }
+
+    void resize ( size_type new_size_ = 0 ) {
+        size_type const old_size = size ( );
+        if ( new_size_ < old_size ) {
+            destroy_rows ( new_size_, old_size );
+            size_ref ( ) = new_size_;
+            return;
+        }
+        if ( new_size_ > capacity ( ) or not m_data )
+            relocate ( new_size_ );
+        size_type const cap = capacity_ref ( );
+        construct_rows ( m_data, cap, old_size, new_size_, [ this, old_size, new_size_, cap ] ( auto i_ ) {
+            auto const col = column_ptr<decltype ( i_ )::value> ( m_data, cap );
+            std::uninitialized_value_construct ( col + old_size, col + new_size_ );
+        } );
+        size_ref ( ) = new_size_;
+    }
+
+    // Access.
+
+    template<std::size_t I>
+    [[nodiscard]] column_type<I> const * data ( ) const noexcept {
+        return m_data ? column_ptr<I> ( m_data, capacity_ref ( ) ) : nullptr;
+    }
+    template<std::size_t I>
+    [[nodiscard]] column_type<I> * data ( ) noexcept {
+        return const_cast<column_type<I> *> ( std::as_const ( *this ).template data<I> ( ) );
+    }
+
+    template<std::size_t I>
+    [[nodiscard]] std::span<column_type<I> const> column ( ) const noexcept {
+        return { data<I> ( ), static_cast<std::size_t> ( size ( ) ) };
+    }
+    template<std::size_t I>
+    [[nodiscard]] std::span<column_type<I>> column ( ) noexcept {
+        return { data<I> ( ), static_cast<std::size_t> ( size ( ) ) };
+    }
+
+    [[nodiscard]] const_reference operator[] ( size_type const i_ ) const noexcept {
+        assert ( not( i_ < size_type{ 0 } ) );
+        assert ( not( i_ >= size ( ) ) );
+        return row<const_reference> ( *this, i_, std::index_sequence_for<Ts...>{ } );
+    }
+    [[nodiscard]] reference operator[] ( size_type const i_ ) noexcept {
+        assert ( not( i_ < size_type{ 0 } ) );
+        assert ( not( i_ >= size ( ) ) );
+        return row<reference> ( *this, i_, std::index_sequence_for<Ts...>{ } );
+    }
+
+    [[nodiscard]] const_reference back ( ) const noexcept { return operator[] ( size ( ) - size_type{ 1 } ); }
+    [[nodiscard]] reference back ( ) noexcept { return operator[] ( size ( ) - size_type{ 1 } ); }
+
+    // Sizes.
+
+    [[nodiscard]] static constexpr size_type max_size ( ) noexcept { return std::numeric_limits<size_type>::max ( ); }
+
+    [[nodiscard]] size_type capacity ( ) const noexcept { return m_data ? capacity_ref ( ) : 0; }
+    [[nodiscard]] size_type size ( ) const noexcept { return m_data ? size_ref ( ) : 0; }
+
+    [[nodiscard]] bool empty ( ) const noexcept { return not m_data or not size_ref ( ); }
+
+    // Emplace/Pop, takes one (constructor argument for a) value per column.
+
+    template<typename... Args>
+    [[maybe_unused]] reference emplace_back ( Args &&... args_ ) {
+        static_assert ( sizeof...( Args ) == columns, "Exactly one argument per column is required" );
+        if ( size ( ) == capacity ( ) ) // (re)locate.
+            relocate ( grow_capacity ( capacity ( ) ) );
+        size_type const s = size_ref ( ), cap = capacity_ref ( );
+        auto args         = std::forward_as_tuple ( std::forward<Args> ( args_ )... );
+        construct_rows ( m_data, cap, s, s + 1, [ this, &args, s, cap ] ( auto i_ ) {
+            constexpr std::size_t I = decltype ( i_ )::value;
+            new ( column_ptr<I> ( m_data, cap ) + s ) column_type<I>{ std::get<I> ( std::move ( args ) ) };
+        } );
+        ++size_ref ( );
+        return back ( );
+    }
+
+    [[maybe_unused]] reference push_back ( Ts const &... v_ ) { return emplace_back ( v_... ); }
+
+    void pop_back ( ) noexcept {
+        assert ( size ( ) );
+        destroy_rows ( size_ref ( ) - size_type{ 1 }, size_ref ( ) );
+        --size_ref ( );
+    }
+
+    // Swap.
+
+    void swap ( basic_compact_soa_vector & rhs_ ) noexcept { std::swap ( m_data, rhs_.m_data ); }
+
+    private:
+    template<typename Function>
+    static void for_each_column ( Function && fn_ ) {
+        [ &fn_ ]<std::size_t... I> ( std::index_sequence<I...> ) {
+            ( fn_ ( std::integral_constant<std::size_t, I>{ } ), ... );
+        }( std::index_sequence_for<Ts...>{ } );
+    }
+
+    // Construct rows [first_, last_) in the block data_ of capacity cap_, a column at a time by fn_ ( column
+    // index ), which leaves its column as it was if it throws. Then the rows of the columns constructed
+    // before are destroyed, before rethrowing.
+    template<typename Function>
+    static void construct_rows ( void_ptr data_, size_type const cap_, size_type const first_, size_type const last_,
+                                 Function && fn_ ) {
+        std::size_t constructed = 0;
+        try {
+            for_each_column ( [ &fn_, &constructed ] ( auto i_ ) {
+                fn_ ( i_ );
+                ++constructed;
+            } );
+        }
+        catch ( ... ) {
+            for_each_column ( [ data_, cap_, first_, last_, constructed ] ( auto i_ ) {
+                constexpr std::size_t I = decltype ( i_ )::value;
+                if ( I < constructed ) {
+                    auto const col = column_ptr<I> ( data_, cap_ );
+                    std::destroy ( col + first_, col + last_ );
+                }
+            } );
+            throw;
+        }
+    }
+
+    template<typename Reference, typename Self, std::size_t... I>
+    [[nodiscard]] static Reference row ( Self & self_, size_type const i_, std::index_sequence<I...> ) noexcept {
+        return Reference{ self_.template data<I> ( )[ i_ ]... };
+    }
+
+    [[nodiscard]] static constexpr std::size_t round_up ( std::size_t n_ ) noexcept {
+        return ( n_ + column_alignment - 1 ) & ~( column_alignment - 1 );
+    }
+
+    [[nodiscard]] static constexpr std::size_t column_offset ( std::size_t const i_, size_type const cap_ ) noexcept {
+        constexpr std::size_t sizes[]{ sizeof ( Ts )... };
+        std::size_t o = 0;
+        for ( std::size_t i = 0; i < i_; ++i )
+            o += round_up ( static_cast<std::size_t> ( cap_ ) * sizes[ i ] );
+        return o;
+    }
+
+    template<std::size_t I>
+    [[nodiscard]] static column_type<I> * column_ptr ( void_ptr data_, size_type const cap_ ) noexcept {
+        assert ( data_ );
+        return reinterpret_cast<column_type<I> *> ( static_cast<char *> ( data_ ) + column_offset ( I, cap_ ) );
+    }
+
+    void destroy_rows ( size_type const first_, size_type const last_ ) noexcept {
+        size_type const cap = capacity_ref ( );
+        for_each_column ( [ this, first_, last_, cap ] ( auto i_ ) {
+            auto const col = column_ptr<decltype ( i_ )::value> ( m_data, cap );
+            std::destroy ( col + first_, col + last_ );
+        } );
+    }
+
+    // Move all columns into a new block of capacity cap_, at least size. The old columns are destroyed
+    // once all are moved, if a move throws, the new block is freed and the old block is kept.
+    void relocate ( size_type const cap_ ) {
+        size_type const s = size ( );
+        assert ( cap_ >= s );
+        void_ptr const p = cv_malloc ( cap_, s );
+        if ( m_data ) {
+            size_type const cap = capacity_ref ( );
+            try {
+                construct_rows ( p, cap_, 0, s, [ this, p, s, cap, cap_ ] ( auto i_ ) {
+                    constexpr std::size_t I = decltype ( i_ )::value;
+                    using type              = column_type<I>;
+                    type * const src        = column_ptr<I> ( m_data, cap );
+                    type * const dst        = column_ptr<I> ( p, cap_ );
+                    if constexpr ( std::is_trivially_copyable_v<type> )
+                        std::memcpy ( dst, src, static_cast<std::size_t> ( s ) * sizeof ( type ) );
+                    else
+                        std::uninitialized_move ( src, src + s, dst );
+                } );
+            }
+            catch ( ... ) {
+                cv_free ( p );
+                throw;
+            }
+            destroy_rows ( 0, s );
+            cv_free ( m_data );
+        }
+        m_data = p;
+    }
+
+    // The header, rounded up to the alignment, sits in front of the first column.
+    static constexpr std::size_t header_size = ( sizeof ( params ) + column_alignment - 1 ) & ~( column_alignment - 1 );
+
+    [[nodiscard]] static void_ptr cv_malloc ( size_type cap_, size_type siz_ = 0 ) {
+        char * const mem =
+            static_cast<char *> ( detail::cv::aligned_malloc ( column_alignment, header_size + column_offset ( columns, cap_ ) ) );
+        new ( mem + header_size - sizeof ( params ) ) params{ cap_, siz_ };
+        return mem + header_size;
+    }
+
+    static void cv_free ( void_ptr data_ ) noexcept {
+        detail::cv::aligned_free ( static_cast<char *> ( data_ ) - header_size );
+    }
+
+    // The MSVC-growth strategy for std::vector.
+    [[nodiscard]] static size_type grow_capacity ( size_type c_ ) noexcept {
+        return c_ > 1 ? std::min ( max_size ( ), c_ + c_ / 2 ) : size_type{ 2 };
+    }
+
+    [[nodiscard]] inline params const & params_ref ( ) const noexcept {
+        assert ( m_data );
+        return *reinterpret_cast<params const *> ( static_cast<char const *> ( m_data ) - sizeof ( params ) );
+    }
+    [[nodiscard]] inline size_type const & capacity_ref ( ) const noexcept { return params_ref ( ).capacity; }
+    [[nodiscard]] inline size_type const & size_ref ( ) const noexcept { return params_ref ( ).size; }
+
+    [[nodiscard]] inline params & params_ref ( ) noexcept {
+        return const_cast<params &> ( std::as_const ( *this ).params_ref ( ) );
+    }
+    [[nodiscard]] inline size_type & capacity_ref ( ) noexcept { return params_ref ( ).capacity; }
+    [[nodiscard]] inline size_type & size_ref ( ) noexcept { return params_ref ( ).size; }
+
+    // Column alignment.
+    void_ptr m_data = nullptr;
+};
+
+template<typename... Ts>
+using compact_soa_vector = basic_compact_soa_vector<int, detail::cv::simd_alignment, Ts...>;
+
+} // namespace sax
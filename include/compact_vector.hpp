@@ -27,12 +27,30 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 #include <algorithm>
+#include <bit>
+#include <charconv>
+#include <compare>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <locale>
 #include <sax/iostream.hpp>
+#include <string>
+#include <string_view>
+#include <system_error>
 #include <type_traits>
 #include <utility>
 
+#if defined( _MSC_VER )
+#    include <malloc.h>
+#    if not defined( __clang__ )
+#        include <intrin.h>
+#    endif
+#endif
+
 // Costumization point.
 
 #ifndef USE_MIMALLOC
@@ -57,6 +75,10 @@ namespace detail::cv {
 [[nodiscard]] inline void * calloc ( std::size_t num_, std::size_t size_ ) noexcept { return mi_calloc ( num_, size_ ); }
 [[nodiscard]] inline void * realloc ( void * ptr_, std::size_t new_size_ ) noexcept { return mi_realloc ( ptr_, new_size_ ); }
 inline void free ( void * ptr_ ) noexcept { mi_free ( ptr_ ); }
+[[nodiscard]] inline void * aligned_malloc ( std::size_t alignment_, std::size_t size_ ) noexcept {
+    return mi_malloc_aligned ( size_, alignment_ );
+}
+inline void aligned_free ( void * ptr_ ) noexcept { mi_free ( ptr_ ); }
 
 namespace {
 
@@ -76,7 +98,258 @@ inline bool const windows_eager_region_commit = [] {
 [[nodiscard]] inline void * calloc ( std::size_t num_, std::size_t size_ ) noexcept { return std::calloc ( num_, size_ ); }
 [[nodiscard]] inline void * realloc ( void * ptr_, std::size_t new_size_ ) noexcept { return std::realloc ( ptr_, new_size_ ); }
 inline void free ( void * ptr_ ) noexcept { std::free ( ptr_ ); }
+#    if defined( _MSC_VER )
+[[nodiscard]] inline void * aligned_malloc ( std::size_t alignment_, std::size_t size_ ) noexcept {
+    return _aligned_malloc ( size_, alignment_ );
+}
+inline void aligned_free ( void * ptr_ ) noexcept { _aligned_free ( ptr_ ); }
+#    else
+[[nodiscard]] inline void * aligned_malloc ( std::size_t alignment_, std::size_t size_ ) noexcept {
+    return std::aligned_alloc ( alignment_, ( size_ + alignment_ - 1 ) & ~( alignment_ - 1 ) ); // size must be a multiple.
+}
+inline void aligned_free ( void * ptr_ ) noexcept { std::free ( ptr_ ); }
+#    endif
+#endif
+
+// Hint the hardware to pull the cache line holding p_ into L1.
+inline void prefetch ( void const * p_ ) noexcept {
+#if defined( _MSC_VER ) and not defined( __clang__ )
+    _mm_prefetch ( reinterpret_cast<char const *> ( p_ ), _MM_HINT_T0 );
+#else
+    __builtin_prefetch ( p_ );
+#endif
+}
+
+// Hashing, a wyhash-style hash over a contiguous block of bytes. The body consumes 48 bytes per
+// iteration in 3 independent multiply-mix lanes, which keeps the multipliers busy without the need
+// for explicit SIMD.
+
+inline constexpr std::uint64_t hash_secret[ 4 ]{ 0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull,
+                                                  0x589965cc75374cc3ull };
+
+// The 128-bit product of a_ and b_, the low half in a_, the high half in b_.
+inline void mum ( std::uint64_t & a_, std::uint64_t & b_ ) noexcept {
+#if defined( _MSC_VER ) and not defined( __clang__ ) and defined( _M_X64 )
+    a_ = _umul128 ( a_, b_, &b_ );
+#elif defined( _MSC_VER ) and not defined( __clang__ ) and defined( _M_ARM64 )
+    std::uint64_t const lo = a_ * b_;
+    b_                     = __umulh ( a_, b_ );
+    a_                     = lo;
+#elif defined( __SIZEOF_INT128__ )
+    __uint128_t const r = static_cast<__uint128_t> ( a_ ) * b_;
+    a_                  = static_cast<std::uint64_t> ( r );
+    b_                  = static_cast<std::uint64_t> ( r >> 64 );
+#else
+    // 32-bit targets, multiply in 32-bit halves.
+    std::uint64_t const al = a_ & 0xFFFF'FFFFu, ah = a_ >> 32, bl = b_ & 0xFFFF'FFFFu, bh = b_ >> 32;
+    std::uint64_t const ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+    std::uint64_t const mid = ( ll >> 32 ) + ( lh & 0xFFFF'FFFFu ) + ( hl & 0xFFFF'FFFFu );
+    a_                      = ( ll & 0xFFFF'FFFFu ) | ( mid << 32 );
+    b_                      = hh + ( lh >> 32 ) + ( hl >> 32 ) + ( mid >> 32 );
 #endif
+}
+
+[[nodiscard]] inline std::uint64_t mix ( std::uint64_t a_, std::uint64_t b_ ) noexcept {
+    mum ( a_, b_ );
+    return a_ ^ b_;
+}
+
+[[nodiscard]] inline std::uint64_t read64 ( unsigned char const * p_ ) noexcept {
+    std::uint64_t v;
+    std::memcpy ( &v, p_, sizeof ( v ) );
+    return v;
+}
+[[nodiscard]] inline std::uint64_t read32 ( unsigned char const * p_ ) noexcept {
+    std::uint32_t v;
+    std::memcpy ( &v, p_, sizeof ( v ) );
+    return v;
+}
+
+[[nodiscard]] inline std::uint64_t hash_bytes ( void const * ptr_, std::size_t len_, std::uint64_t seed_ = 0 ) noexcept {
+    unsigned char const * p = static_cast<unsigned char const *> ( ptr_ );
+    seed_ ^= mix ( seed_ ^ hash_secret[ 0 ], hash_secret[ 1 ] );
+    std::uint64_t a, b;
+    if ( len_ <= 16 ) {
+        if ( len_ >= 4 ) {
+            std::size_t const o = ( len_ >> 3 ) << 2;
+            a                   = ( read32 ( p ) << 32 ) | read32 ( p + o );
+            b                   = ( read32 ( p + len_ - 4 ) << 32 ) | read32 ( p + len_ - 4 - o );
+        }
+        else if ( len_ ) {
+            a = ( std::uint64_t{ p[ 0 ] } << 16 ) | ( std::uint64_t{ p[ len_ >> 1 ] } << 8 ) | p[ len_ - 1 ];
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else {
+        std::size_t i = len_;
+        if ( i > 48 ) {
+            std::uint64_t see1 = seed_, see2 = seed_;
+            do {
+                seed_ = mix ( read64 ( p ) ^ hash_secret[ 1 ], read64 ( p + 8 ) ^ seed_ );
+                see1  = mix ( read64 ( p + 16 ) ^ hash_secret[ 2 ], read64 ( p + 24 ) ^ see1 );
+                see2  = mix ( read64 ( p + 32 ) ^ hash_secret[ 3 ], read64 ( p + 40 ) ^ see2 );
+                p += 48;
+                i -= 48;
+            } while ( i > 48 );
+            seed_ ^= see1 ^ see2;
+        }
+        while ( i > 16 ) {
+            seed_ = mix ( read64 ( p ) ^ hash_secret[ 1 ], read64 ( p + 8 ) ^ seed_ );
+            i -= 16;
+            p += 16;
+        }
+        a = read64 ( p + i - 16 );
+        b = read64 ( p + i - 8 );
+    }
+    a ^= hash_secret[ 1 ];
+    b ^= seed_;
+    mum ( a, b );
+    return mix ( a ^ hash_secret[ 0 ] ^ len_, b ^ hash_secret[ 1 ] );
+}
+
+// Types for which a lexicographical compare is a memcmp.
+template<typename Type>
+inline constexpr bool is_memcmp_comparable_v = std::is_same_v<Type, unsigned char> or std::is_same_v<Type, std::byte> or
+                                               std::is_same_v<Type, char8_t> or
+                                               ( std::is_same_v<Type, char> and std::is_unsigned_v<char> );
+
+// Types for which equality is equality of the object representation, i.e. which hash bytewise. Class
+// types are excluded, their operator== may well compare less than all bytes.
+template<typename Type>
+inline constexpr bool is_bytewise_hashable_v = std::is_scalar_v<Type> and std::has_unique_object_representations_v<Type>;
+
+// Text conversion.
+
+template<typename Type>
+inline constexpr bool is_character_v =
+    std::is_same_v<Type, char> or std::is_same_v<Type, signed char> or std::is_same_v<Type, unsigned char> or
+    std::is_same_v<Type, wchar_t> or std::is_same_v<Type, char8_t> or std::is_same_v<Type, char16_t> or
+    std::is_same_v<Type, char32_t>;
+
+// Types std::to_chars and std::from_chars can convert.
+template<typename Type>
+inline constexpr bool is_charconv_v = std::is_arithmetic_v<Type> and not std::is_same_v<Type, bool>;
+
+// Types that an ostream formats as a (decimal) number, identical to std::to_chars.
+template<typename Type>
+inline constexpr bool is_streamed_as_integer_v =
+    std::is_integral_v<Type> and not std::is_same_v<Type, bool> and not is_character_v<Type>;
+
+// Upper bound on the number of characters std::to_chars writes for one value, the shortest round-trip
+// representation of a floating point value is never longer than its scientific notation.
+template<typename Type>
+inline constexpr std::size_t max_chars_v = std::is_integral_v<Type> ? std::numeric_limits<Type>::digits10 + 2
+                                                                     : std::numeric_limits<Type>::max_digits10 + 8;
+
+// Sorting.
+
+// Arithmetic types with an unsigned key of the same size and order.
+template<typename Type>
+inline constexpr bool is_radix_sortable_v =
+    ( std::is_integral_v<Type> and not std::is_same_v<Type, bool> ) or
+    ( std::is_floating_point_v<Type> and std::numeric_limits<Type>::is_iec559 and
+      ( sizeof ( Type ) == 4 or sizeof ( Type ) == 8 ) );
+
+template<std::size_t Size>
+using unsigned_of_size = std::conditional_t<
+    Size == 1, std::uint8_t,
+    std::conditional_t<Size == 2, std::uint16_t, std::conditional_t<Size == 4, std::uint32_t, std::uint64_t>>>;
+
+// Map a value onto an unsigned key, such that the keys order as the values do.
+template<typename Type>
+[[nodiscard]] inline unsigned_of_size<sizeof ( Type )> radix_key ( Type const v_ ) noexcept {
+    using key_type          = unsigned_of_size<sizeof ( Type )>;
+    constexpr key_type sign = static_cast<key_type> ( key_type{ 1 } << ( 8 * sizeof ( Type ) - 1 ) );
+    key_type const k        = std::bit_cast<key_type> ( v_ );
+    if constexpr ( std::is_unsigned_v<Type> )
+        return k;
+    else if constexpr ( std::is_integral_v<Type> )
+        return static_cast<key_type> ( k ^ sign );
+    else // Negative floats order reversed.
+        return k & sign ? static_cast<key_type> ( ~k ) : static_cast<key_type> ( k | sign );
+}
+
+// LSD radix sort on bytes, ping-ponging between [first_, last_) and buffer_. Histograms for all
+// passes are built in a single pass over the data, passes in which all keys share the same byte
+// are skipped.
+template<typename Type>
+void radix_sort ( Type * const first_, Type * const last_, Type * const buffer_ ) noexcept {
+    constexpr std::size_t passes = sizeof ( Type );
+    std::size_t const n          = static_cast<std::size_t> ( last_ - first_ );
+    std::size_t counts[ passes ][ 256 ]{ };
+    for ( Type const * p = first_; p != last_; ++p ) {
+        auto const k = radix_key ( *p );
+        for ( std::size_t i = 0; i < passes; ++i )
+            ++counts[ i ][ ( k >> ( 8 * i ) ) & 0xff ];
+    }
+    Type *src = first_, *dst = buffer_;
+    for ( std::size_t i = 0; i < passes; ++i ) {
+        std::size_t * const c = counts[ i ];
+        if ( c[ ( radix_key ( *src ) >> ( 8 * i ) ) & 0xff ] == n )
+            continue;
+        for ( std::size_t d = 0, sum = 0; d < 256; ++d )
+            sum += std::exchange ( c[ d ], sum );
+        for ( Type const * p = src, *e = src + n; p != e; ++p )
+            dst[ c[ ( radix_key ( *p ) >> ( 8 * i ) ) & 0xff ]++ ] = *p;
+        std::swap ( src, dst );
+    }
+    if ( src != first_ )
+        std::memcpy ( first_, src, n * sizeof ( Type ) );
+}
+
+// Optimal sorting networks (compare-exchange pairs) for up to 8 values.
+inline constexpr std::size_t sorting_network_max = 8;
+inline constexpr std::uint8_t sorting_network_sizes[ sorting_network_max + 1 ]{ 0, 0, 1, 3, 5, 9, 12, 16, 19 };
+inline constexpr std::uint8_t sorting_networks[ sorting_network_max + 1 ][ 19 ][ 2 ]{
+    { },
+    { },
+    { { 0, 1 } },
+    { { 0, 2 }, { 0, 1 }, { 1, 2 } },
+    { { 0, 2 }, { 1, 3 }, { 0, 1 }, { 2, 3 }, { 1, 2 } },
+    { { 0, 3 }, { 1, 4 }, { 0, 2 }, { 1, 3 }, { 0, 1 }, { 2, 4 }, { 1, 2 }, { 3, 4 }, { 2, 3 } },
+    { { 0, 5 }, { 1, 3 }, { 2, 4 }, { 1, 2 }, { 3, 4 }, { 0, 3 }, { 2, 5 }, { 0, 1 }, { 2, 3 }, { 4, 5 }, { 1, 2 }, { 3, 4 } },
+    { { 0, 6 }, { 2, 3 }, { 4, 5 }, { 0, 2 }, { 1, 4 }, { 3, 6 }, { 0, 1 }, { 2, 5 }, { 3, 4 }, { 1, 2 }, { 4, 6 }, { 2, 3 },
+      { 4, 5 }, { 1, 2 }, { 3, 4 }, { 5, 6 } },
+    { { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }, { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+      { 2, 4 }, { 3, 5 }, { 1, 4 }, { 3, 6 }, { 1, 2 }, { 3, 4 }, { 5, 6 } }
+};
+
+template<typename Type>
+void sorting_network ( Type * const first_, std::size_t const n_ ) noexcept {
+    assert ( n_ <= sorting_network_max );
+    for ( std::size_t i = 0; i < sorting_network_sizes[ n_ ]; ++i ) {
+        Type & a = first_[ sorting_networks[ n_ ][ i ][ 0 ] ];
+        Type & b = first_[ sorting_networks[ n_ ][ i ][ 1 ] ];
+        Type const lo = b < a ? b : a, hi = b < a ? a : b; // Branchless (cmov) compare-exchange.
+        a = lo;
+        b = hi;
+    }
+}
+
+// Below this size std::sort beats the radix sort.
+inline constexpr std::size_t radix_sort_min = 256;
+
+template<typename Type>
+void sort ( Type * const first_, Type * const last_ ) {
+    std::size_t const n = static_cast<std::size_t> ( last_ - first_ );
+    if constexpr ( is_radix_sortable_v<Type> ) {
+        if ( n <= sorting_network_max ) {
+            sorting_network ( first_, n );
+            return;
+        }
+        if ( n >= radix_sort_min ) {
+            if ( Type * const buffer = static_cast<Type *> ( malloc ( n * sizeof ( Type ) ) ); buffer ) {
+                radix_sort ( first_, last_, buffer );
+                free ( buffer );
+                return;
+            }
+        }
+    }
+    std::sort ( first_, last_ );
+}
 
 template<typename Type, typename SizeType = int>
 struct params {
@@ -264,17 +537,35 @@ class compact_vector {
         return const_cast<reference> ( std::as_const ( *this ).operator[] ( i_ ) );
     }
 
-    // Compare for equality.
+    // Compare for equality, a released vector compares equal to an empty one.
 
     [[nodiscard]] bool operator== ( compact_vector const & rhs_ ) const noexcept {
         if ( m_data == rhs_.m_data ) // includes comparing 2 nullptrs.
             return true;
-        if ( not m_data or not rhs_.m_data or size_ref ( ) != rhs_.size_ref ( ) )
+        size_type const s = size ( );
+        if ( s != rhs_.size ( ) )
             return false;
+        if ( not s )
+            return true;
         return std::equal ( begin ( ), end ( ), rhs_.begin ( ), rhs_.end ( ) );
     }
     [[nodiscard]] bool operator!= ( compact_vector const & rhs_ ) const noexcept { return not operator== ( rhs_ ); }
 
+    // Compare lexicographically, byte-like types compare with memcmp.
+
+    [[nodiscard]] auto operator<=> ( compact_vector const & rhs_ ) const noexcept requires std::three_way_comparable<value_type> {
+        size_type const l = size ( ), r = rhs_.size ( );
+        if constexpr ( detail::cv::is_memcmp_comparable_v<value_type> ) {
+            if ( size_type const n = std::min ( l, r ); n )
+                if ( int const c = std::memcmp ( m_data, rhs_.m_data, static_cast<std::size_t> ( n ) ); c )
+                    return c <=> 0;
+            return l <=> r;
+        }
+        else {
+            return std::lexicographical_compare_three_way ( m_data, m_data + l, rhs_.m_data, rhs_.m_data + r );
+        }
+    }
+
     // Data.
 
     [[nodiscard]] const_pointer data ( ) const noexcept { return m_data; }
@@ -346,6 +637,94 @@ class compact_vector {
         m_data[ --size_ref ( ) ].~Type ( );
     }
 
+    // Bulk append.
+
+    // Appends to a compact_vector through a cursor held in the writer itself, instead of through the
+    // size in the header, so that in a tight loop the cursor can live in a register. Space for n_
+    // values is reserved on construction, the values are constructed unchecked (asserted only) and
+    // the size is written back to the header once, on commit ( ) or destruction.
+    class bulk_writer {
+
+        public:
+        bulk_writer ( compact_vector & cv_, size_type const n_ ) : m_cv{ cv_ } {
+            assert ( n_ <= max_allocation_size - cv_.size ( ) );
+            cv_.reserve ( cv_.size ( ) + n_ );
+            m_cursor = cv_.m_data + cv_.size_ref ( );
+            m_last   = cv_.m_data + cv_.capacity_ref ( );
+        }
+
+        ~bulk_writer ( ) noexcept { commit ( ); }
+
+        bulk_writer ( ) noexcept            = delete;
+        bulk_writer ( bulk_writer const & ) = delete;
+        bulk_writer ( bulk_writer && )      = delete;
+
+        bulk_writer & operator= ( bulk_writer const & ) = delete;
+        bulk_writer & operator= ( bulk_writer && ) = delete;
+
+        template<typename... Args>
+        [[maybe_unused]] reference emplace_back ( Args &&... args_ ) {
+            assert ( m_cursor < m_last );
+            return *new ( m_cursor++ ) value_type{ std::forward<Args> ( args_ )... };
+        }
+
+        [[maybe_unused]] reference push_back ( const_reference v_ ) { return emplace_back ( v_ ); }
+
+        // The raw cursor, values constructed at [cursor ( ), cursor ( ) + n) are appended by advance ( n ).
+        [[nodiscard]] pointer cursor ( ) const noexcept { return m_cursor; }
+        void advance ( size_type const n_ = 1 ) noexcept {
+            assert ( n_ <= remaining ( ) );
+            m_cursor += n_;
+        }
+
+        [[nodiscard]] size_type remaining ( ) const noexcept { return static_cast<size_type> ( m_last - m_cursor ); }
+
+        // Write the size back to the header.
+        void commit ( ) noexcept { m_cv.size_ref ( ) = static_cast<size_type> ( m_cursor - m_cv.m_data ); }
+
+        private:
+        compact_vector & m_cv;
+        pointer m_cursor, m_last;
+    };
+
+    [[nodiscard]] bulk_writer writer ( size_type const n_ ) { return bulk_writer{ *this, n_ }; }
+
+    // Reserve space for n_ more values and pass a pointer to the first one to fn_, which constructs
+    // at most n_ values and returns the pointer past the last value it constructed. Returns the
+    // number of values appended.
+    template<typename Function>
+    [[maybe_unused]] size_type append_with ( size_type const n_, Function fn_ ) {
+        reserve ( size ( ) + n_ );
+        pointer const first = m_data + size_ref ( );
+        pointer const last  = fn_ ( first );
+        assert ( first <= last and last <= first + n_ );
+        size_ref ( ) += static_cast<size_type> ( last - first );
+        return static_cast<size_type> ( last - first );
+    }
+
+    // Sort/Unique.
+
+    // Sort ascending. Arithmetic value types sort with a sorting network if tiny, with a radix sort
+    // (scratch space from the same allocator) if large, all others with std::sort.
+    void sort ( ) {
+        if ( m_data )
+            detail::cv::sort ( m_data, m_data + size_ref ( ) );
+    }
+
+    // Remove consecutive duplicates, returns the new size.
+    [[maybe_unused]] size_type unique ( ) {
+        if ( not m_data )
+            return 0;
+        pointer const last = std::unique ( m_data, m_data + size_ref ( ) );
+        std::for_each ( last, m_data + size_ref ( ), [] ( value_type & value_ref ) { value_ref.~Type ( ); } );
+        return size_ref ( ) = static_cast<size_type> ( last - m_data );
+    }
+
+    [[maybe_unused]] size_type sort_unique ( ) {
+        sort ( );
+        return unique ( );
+    }
+
     // Swap.
 
     void swap ( compact_vector & rhs_ ) noexcept { std::swap ( m_data, rhs_.m_data ); }
@@ -409,13 +788,98 @@ class compact_vector {
 
     */
 
+    // Text conversion.
+
+    // The number of characters to_chars ( ) needs at most.
+    [[nodiscard]] std::size_t max_chars ( std::string_view const sep_ = " " ) const noexcept {
+        static_assert ( detail::cv::is_charconv_v<value_type>, "Value type is not convertible with std::to_chars" );
+        std::size_t const s = static_cast<std::size_t> ( size ( ) );
+        return s ? s * detail::cv::max_chars_v<value_type> + ( s - 1 ) * sep_.size ( ) : 0;
+    }
+
+    // Format the values, separated by sep_, into [first_, last_). Follows the std::to_chars contract,
+    // on std::errc::value_too_large the contents of [first_, last_) are unspecified.
+    [[nodiscard]] std::to_chars_result to_chars ( char * first_, char * last_, std::string_view const sep_ = " " ) const noexcept {
+        static_assert ( detail::cv::is_charconv_v<value_type>, "Value type is not convertible with std::to_chars" );
+        if ( empty ( ) )
+            return { first_, std::errc{ } };
+        const_pointer p = m_data, e = m_data + size_ref ( );
+        while ( true ) {
+            std::to_chars_result const r = std::to_chars ( first_, last_, *p );
+            if ( r.ec != std::errc{ } or ++p == e )
+                return r;
+            if ( static_cast<std::size_t> ( last_ - r.ptr ) < sep_.size ( ) )
+                return { last_, std::errc::value_too_large };
+            first_ = std::copy ( sep_.begin ( ), sep_.end ( ), r.ptr );
+        }
+    }
+
+    [[nodiscard]] std::string to_string ( std::string_view const sep_ = " " ) const {
+        std::string s ( max_chars ( sep_ ), '\0' );
+        s.resize ( static_cast<std::size_t> ( to_chars ( s.data ( ), s.data ( ) + s.size ( ), sep_ ).ptr - s.data ( ) ) );
+        return s;
+    }
+
+    // Parse sep_-separated values from [first_, last_) and append them through a bulk_writer, space
+    // for all values is reserved up front. Parsing stops at the first character that does not continue
+    // the sequence, which is returned in ptr, a value that fails to parse is reported in ec, as with
+    // std::from_chars.
+    [[maybe_unused]] std::from_chars_result from_chars ( char const * first_, char const * last_,
+                                                         std::string_view const sep_ = " " ) {
+        static_assert ( detail::cv::is_charconv_v<value_type>, "Value type is not convertible with std::from_chars" );
+        assert ( not sep_.empty ( ) );
+        if ( first_ == last_ )
+            return { first_, std::errc{ } };
+        std::string_view const text{ first_, static_cast<std::size_t> ( last_ - first_ ) };
+        size_type n = 1;
+        if ( 1 == sep_.size ( ) )
+            n += static_cast<size_type> ( std::count ( first_, last_, sep_.front ( ) ) );
+        else
+            for ( std::size_t i = text.find ( sep_ ); std::string_view::npos != i; i = text.find ( sep_, i + sep_.size ( ) ) )
+                ++n;
+        bulk_writer writer{ *this, n };
+        while ( true ) {
+            value_type v;
+            std::from_chars_result const r = std::from_chars ( first_, last_, v );
+            if ( r.ec != std::errc{ } )
+                return r;
+            writer.emplace_back ( v );
+            first_ = r.ptr;
+            if ( not std::string_view{ first_, static_cast<std::size_t> ( last_ - first_ ) }.starts_with ( sep_ ) )
+                return { first_, std::errc{ } };
+            first_ += sep_.size ( );
+            if ( first_ == last_ ) // Trailing separator.
+                return { first_, std::errc{ } };
+        }
+    }
+
     // Output.
 
     template<typename Stream>
     [[maybe_unused]] friend Stream & operator<< ( Stream & out_, compact_vector const & m_ ) noexcept {
-        if ( m_.data ( ) )
+        if ( m_.data ( ) ) {
+            if constexpr ( detail::cv::is_streamed_as_integer_v<value_type> and std::is_base_of_v<std::ostream, Stream> ) {
+                // Only where the stream would format as std::to_chars does: decimal, no sign, no padding, no grouping.
+                if ( ( out_.flags ( ) & ( std::ios_base::basefield | std::ios_base::showpos ) ) == std::ios_base::dec and
+                     not out_.width ( ) and out_.getloc ( ) == std::locale::classic ( ) ) {
+                    // Format in chunks with std::to_chars, bypassing the per-value formatting of the stream.
+                    char buffer[ 4'096 ];
+                    char * p = buffer;
+                    for ( auto const & e : m_ ) {
+                        if ( static_cast<std::size_t> ( std::end ( buffer ) - p ) <= detail::cv::max_chars_v<value_type> ) {
+                            out_.write ( buffer, p - buffer );
+                            p = buffer;
+                        }
+                        p    = std::to_chars ( p, std::end ( buffer ), e ).ptr;
+                        *p++ = ' ';
+                    }
+                    out_.write ( buffer, p - buffer );
+                    return out_;
+                }
+            }
             for ( auto const & e : m_ )
                 out_ << e << sp; // A wide- or narrow-string space, as appropriate.
+        }
         return out_;
     }
 
@@ -481,4 +945,95 @@ class compact_vector {
     pointer m_data = nullptr;
 };
 
+// Batched traversal.
+
+namespace detail::cv {
+
+// How many vectors ahead of the one being processed the headers (and first data lines) are prefetched.
+inline constexpr std::size_t prefetch_distance = 8;
+
+template<typename CompactVector>
+inline void prefetch_header ( CompactVector const & cv_ ) noexcept {
+    if ( auto const p = cv_.data ( ); p )
+        prefetch ( reinterpret_cast<char const *> ( p ) - sizeof ( typename CompactVector::params ) );
+}
+
+template<typename CompactVector>
+inline void prefetch_header_and_data ( CompactVector const & cv_ ) noexcept {
+    if ( auto const p = cv_.data ( ); p ) {
+        prefetch ( reinterpret_cast<char const *> ( p ) - sizeof ( typename CompactVector::params ) );
+        prefetch ( p );
+    }
+}
+
+} // namespace detail::cv
+
+// Apply fn_ to every compact_vector in [first_, last_), while prefetching the headers and first
+// data lines of the vectors detail::cv::prefetch_distance positions further down the range. Each
+// size ( ), begin ( ) or end ( ) dereferences the header behind the handle, i.e. without prefetching,
+// a walk over a large collection of compact_vectors costs a cache miss per vector.
+template<typename ForwardIt, typename Function>
+[[maybe_unused]] Function for_each_vector ( ForwardIt first_, ForwardIt last_, Function fn_ ) {
+    ForwardIt ahead = first_;
+    for ( std::size_t i = 0; i < detail::cv::prefetch_distance and ahead != last_; ++i, ++ahead )
+        detail::cv::prefetch_header_and_data ( *ahead );
+    for ( ; first_ != last_; ++first_ ) {
+        if ( ahead != last_ ) {
+            detail::cv::prefetch_header_and_data ( *ahead );
+            ++ahead;
+        }
+        fn_ ( *first_ );
+    }
+    return fn_;
+}
+
+// Sum of the sizes of the compact_vectors in [first_, last_), only the headers are prefetched.
+template<typename ForwardIt>
+[[nodiscard]] std::size_t total_size ( ForwardIt first_, ForwardIt last_ ) noexcept {
+    std::size_t total = 0;
+    ForwardIt ahead   = first_;
+    for ( std::size_t i = 0; i < detail::cv::prefetch_distance and ahead != last_; ++i, ++ahead )
+        detail::cv::prefetch_header ( *ahead );
+    for ( ; first_ != last_; ++first_ ) {
+        if ( ahead != last_ ) {
+            detail::cv::prefetch_header ( *ahead );
+            ++ahead;
+        }
+        total += static_cast<std::size_t> ( first_->size ( ) );
+    }
+    return total;
+}
+
+// Flatten the compact_vectors in [first_, last_) into the buffer starting at out_, which must be able
+// to hold total_size ( first_, last_ ) elements. Returns the iterator past the last element written.
+template<typename ForwardIt, typename OutputIt>
+[[maybe_unused]] OutputIt gather ( ForwardIt first_, ForwardIt last_, OutputIt out_ ) {
+    for_each_vector ( first_, last_, [ &out_ ] ( auto const & cv_ ) {
+        if ( cv_.data ( ) )
+            out_ = std::copy ( cv_.begin ( ), cv_.end ( ), out_ );
+    } );
+    return out_;
+}
+
 } // namespace sax
+
+// Hash.
+
+template<typename Type, typename SizeType, SizeType max_allocation_size, SizeType default_allocation_size>
+struct std::hash<sax::compact_vector<Type, SizeType, max_allocation_size, default_allocation_size>> {
+    [[nodiscard]] std::size_t
+    operator( ) ( sax::compact_vector<Type, SizeType, max_allocation_size, default_allocation_size> const & cv_ ) const noexcept {
+        namespace dcv          = sax::detail::cv;
+        std::size_t const size = static_cast<std::size_t> ( cv_.size ( ) );
+        if constexpr ( dcv::is_bytewise_hashable_v<Type> ) { // Hash the payload in bulk.
+            return static_cast<std::size_t> ( dcv::hash_bytes ( cv_.data ( ), size * sizeof ( Type ) ) );
+        }
+        else { // Padding bits, multiple representations of equal values or a user-defined ==, hash element-wise.
+            std::uint64_t h = dcv::mix ( size ^ dcv::hash_secret[ 0 ], dcv::hash_secret[ 1 ] );
+            if ( size )
+                for ( auto const & e : cv_ )
+                    h = dcv::mix ( h ^ static_cast<std::uint64_t> ( std::hash<Type>{ }( e ) ), dcv::hash_secret[ 2 ] );
+            return static_cast<std::size_t> ( h );
+        }
+    }
+};